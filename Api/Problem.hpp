@@ -58,6 +58,12 @@ private:
  *
  * The object acts as a reference counted pointer to a mutable list of formulas.
  * To obtain a true copy of the object, one should call the @b clone function.
+ *
+ * All problems share the global environment of Vampire (the signature, term
+ * sharing, options, statistics and the allocator), so the library is not
+ * thread-safe. Calls on different problems, as well as on the objects of the
+ * @b FormulaBuilder they were built with, must not run concurrently; to work
+ * on independent problems in parallel, use separate processes.
  */
 class Problem
 {
@@ -23,6 +23,7 @@
  * @author Andrei Voronkov
  */
 #include <fstream>
+#include <climits>
 #include <cstdlib>
 #include <csignal>
 #include <sstream>
@@ -44,7 +45,9 @@
 
 #include "Shell/Options.hpp"
 #include "Shell/Normalisation.hpp"
+#include "Shell/Preprocess.hpp"
 #include "Saturation/ProvingHelper.hpp"
+#include "Saturation/SaturationAlgorithm.hpp"
 #include "Shell/Statistics.hpp"
 #include "Shell/UIHelper.hpp"
 
@@ -82,6 +85,17 @@ void CLTBMode::perform()
   env.options->setProof(Options::Proof::TPTP);
   env.options->setStatistics(Options::Statistics::NONE);
 
+  if (env.options->ltbAxiomSaturation()) {
+    switch (env.options->saturationAlgorithm()) {
+    case Options::SaturationAlgorithm::DISCOUNT:
+    case Options::SaturationAlgorithm::LRS:
+    case Options::SaturationAlgorithm::OTTER:
+      break;
+    default:
+      USER_ERROR("ltb_axiom_saturation requires the discount, lrs or otter saturation algorithm");
+    }
+  }
+
   vstring line;
   vstring inputFile = env.options->inputFile();
   std::size_t found = inputFile.find_last_of("/");
@@ -149,6 +163,45 @@ void CLTBMode::solveBatch(istream& batchFile, bool first,vstring inputDirectory)
     doTraining();
   }
 
+  if (env.options->ltbAxiomSaturation()) {
+    // the saturation changes global state, such as the numbering of units
+    // after preprocessing, so it lives in a child process solving the problems
+    pid_t saturationChild = Multiprocessing::instance()->fork();
+    if (!saturationChild) {
+      System::registerForSIGHUPOnParentDeath();
+      if (saturateAxioms()) {
+        solveProblems(inputDirectory,terminationTime);
+        System::terminateImmediately(0);
+      }
+      System::terminateImmediately(AXIOM_SATURATION_FAILED);
+    }
+    int resValue = 0;
+    try {
+      pid_t finishedChild = Multiprocessing::instance()->waitForChildTermination(resValue);
+      ASS_EQ(finishedChild, saturationChild);
+    }
+    catch(SystemFailException& ex) {
+      cerr << "% SystemFailException at batch level" << endl;
+      ex.cry(cerr);
+    }
+    Timer::syncClock();
+    if (resValue != AXIOM_SATURATION_FAILED) {
+      return;
+    }
+    coutLineOutput() << "axiom saturation failed, solving the problems without it" << endl;
+  }
+
+  solveProblems(inputDirectory,terminationTime);
+} // CLTBMode::solveBatch(batchFile)
+
+/**
+ * Solve the problems of the batch one after another, each of them
+ * in a child process running CLTBProblem::searchForProof()
+ */
+void CLTBMode::solveProblems(vstring inputDirectory,int terminationTime)
+{
+  CALL("CLTBMode::solveProblems");
+
   int solvedProblems = 0;
   int remainingProblems = _problemFiles.size();
   StringPairStack::BottomFirstIterator probs(_problemFiles);
@@ -245,7 +298,71 @@ void CLTBMode::solveBatch(istream& batchFile, bool first,vstring inputDirectory)
   env.beginOutput();
   lineOutput() << "Solved " << solvedProblems << " out of " << _problemFiles.size() << endl;
   env.endOutput();
-} // CLTBMode::solveBatch(batchFile)
+} // CLTBMode::solveProblems
+
+/**
+ * Preprocess the included axioms and run ltb_axiom_saturation steps of the
+ * saturation algorithm on them. Problems of the batch then add their own
+ * units to the saturation in CLTBProblem::continueAxiomSaturation(), so they
+ * only pay for the inferences with these units.
+ *
+ * Preprocessing steps that look at the whole problem, such as SInE selection
+ * or the removal of pure predicates, would make the saturated axioms
+ * incomplete for the units added later. They are switched off in
+ * env.options, which are also used for the units of the problems.
+ *
+ * Return false if the saturation did not get through the steps, e.g.
+ * because it ran out of memory.
+ */
+bool CLTBMode::saturateAxioms()
+{
+  CALL("CLTBMode::saturateAxioms");
+
+  env.options->set("sine_selection","off");
+  env.options->set("sine_to_age","off");
+  env.options->set("sine_to_pred_levels","off");
+  env.options->set("sine_level_split_queue","off");
+  env.options->set("guess_the_goal","off");
+  env.options->set("unused_predicate_definition_removal","off");
+  env.options->set("function_definition_elimination","none");
+  env.options->set("blocked_clause_elimination","off");
+  env.options->set("equality_proxy","off");
+  env.options->setForcedOptionValues();
+  env.options->checkGlobalOptionConstraints();
+
+  try {
+    _saturatedAxioms = _baseProblem->copy();
+    {
+      TimeCounter tc(TC_PREPROCESSING);
+      Preprocess prepro(*env.options);
+      prepro.preprocess(*_saturatedAxioms);
+    }
+    // the inference engines are chosen by the problem, and problems
+    // may bring equality to axioms without it
+    _saturatedAxioms->reportEqualityAdded(false);
+    Unit::onPreprocessingEnd();
+
+    env.statistics->phase=Statistics::SATURATION;
+    _axiomSaturation = SaturationAlgorithm::createFromOptions(*_saturatedAxioms, *env.options);
+    _axiomSaturationResult = new MainLoopResult(_axiomSaturation->runSteps(env.options->ltbAxiomSaturation()));
+  }
+  catch (Exception& exc) {
+    cerr << "% Exception at axiom saturation" << endl;
+    exc.cry(cerr);
+    return false;
+  }
+
+  switch (_axiomSaturationResult->terminationReason) {
+  case Statistics::TIME_LIMIT:
+  case Statistics::MEMORY_LIMIT:
+  case Statistics::ACTIVATION_LIMIT:
+    return false;
+  default:
+    break;
+  }
+  coutLineOutput() << "axioms saturated to " << env.statistics->activeClauses << " active clauses" << endl;
+  return true;
+} // CLTBMode::saturateAxioms
 
 void CLTBMode::loadIncludes()
 {
@@ -662,7 +779,8 @@ void CLTBProblem::performStrategy(int terminationTime,int timeLimit,Category cat
  * This function solves a single problem. It parses the problem, spawns a
  * writer process for output and creates a pipe to communicate with it.
  * Then it calls performStrategy(terminationTime) that performs the
- * actual proof search.
+ * actual proof search. With ltb_axiom_saturation, the proof search
+ * continues the saturation of the included axioms instead.
  * @param terminationTime the time in milliseconds since the prover start
  * @param timeLimit time limit in milliseconds
  * @since 04/06/2013 flight Manchester-Frankfurt
@@ -695,6 +813,7 @@ void CLTBProblem::searchForProof(int terminationTime,int timeLimit,const Categor
     }
   }
 
+  UnitList* goalUnits = 0;
   // this local scope will delete a potentially large parser
   {
     TimeCounter tc(TC_PARSING);
@@ -716,11 +835,20 @@ void CLTBProblem::searchForProof(int terminationTime,int timeLimit,const Categor
     parser.parse();
     UnitList* probUnits = parser.units();
     UIHelper::setConjecturePresence(parser.containsConjecture());
-    prb.addUnits(probUnits);
+    if (parent->_axiomSaturation) {
+      goalUnits = probUnits;
+    }
+    else {
+      prb.addUnits(probUnits);
+    }
 
     env.options->setOutputAxiomNames(outputAxiomValue);
   }
 
+  if (parent->_axiomSaturation) {
+    continueAxiomSaturation(goalUnits,terminationTime);
+  }
+
   Shell::Property* property = prb.getProperty();
   if (property->atoms()<=1000000) {
     TimeCounter tc(TC_PREPROCESSING);
@@ -954,7 +1082,6 @@ void CLTBProblem::runSlice(Options& strategyOpt)
   System::registerForSIGHUPOnParentDeath();
   UIHelper::portfolioParent = false;
 
-  int resultValue=1;
   env.timer->reset();
   env.timer->start();
   TimeCounter::reinitialize();
@@ -985,7 +1112,19 @@ void CLTBProblem::runSlice(Options& strategyOpt)
   env.endOutput();
 
   ProvingHelper::runVampire(prb, opt);
+  exitWithResult();
+} // CLTBProblem::runSlice
 
+/**
+ * Output the result of the proof search in env.statistics, a proof to the
+ * output file and anything else to the standard output, and exit with
+ * the status 0 iff a refutation was found
+ */
+void CLTBProblem::exitWithResult()
+{
+  CALL("CLTBProblem::exitWithResult");
+
+  int resultValue=1;
   //set return value to zero if we were successful
   if (env.statistics->terminationReason == Statistics::REFUTATION) {
     resultValue=0;
@@ -1006,7 +1145,57 @@ void CLTBProblem::runSlice(Options& strategyOpt)
   }
 
   exit(resultValue);
-} // CLTBProblem::runSlice
+} // CLTBProblem::exitWithResult
+
+/**
+ * Add the units @b goalUnits of the problem to the saturation of the
+ * included axioms made by CLTBMode::saturateAxioms() and continue it until
+ * @b terminationTime, using the options of that saturation. If the axioms
+ * alone were refuted, the refutation is the result.
+ */
+void CLTBProblem::continueAxiomSaturation(UnitList* goalUnits,int terminationTime)
+{
+  CALL("CLTBProblem::continueAxiomSaturation");
+
+  UIHelper::portfolioParent = false;
+
+  int timeLimit = terminationTime - env.timer->elapsedMilliseconds();
+  if (timeLimit < 100) {
+    exitOnNoSuccess();
+  }
+  env.timer->reset();
+  env.timer->start();
+  env.options->setTimeLimitInDeciseconds(milliToDeci(timeLimit));
+  env.options->setProblemName(problemFile);
+  Timer::setTimeLimitEnforcement(true);
+
+  env.beginOutput();
+  CLTBMode::lineOutput() << "axiom saturation continued on " << problemFile << endl;
+  env.endOutput();
+
+  Problem goals(goalUnits);
+  MainLoopResult res = *parent->_axiomSaturationResult;
+  if (res.terminationReason != Statistics::REFUTATION) {
+    {
+      TimeCounter tc(TC_PREPROCESSING);
+      Preprocess prepro(*env.options);
+      prepro.preprocess(goals);
+    }
+    env.statistics->phase=Statistics::SATURATION;
+    SaturationAlgorithm* salg = parent->_axiomSaturation;
+    ClauseIterator cit = goals.clauseIterator();
+    while (cit.hasNext()) {
+      salg->addInputClause(cit.next());
+    }
+    // the time limit ends the run
+    res = salg->runSteps(UINT_MAX);
+  }
+  env.statistics->phase=Statistics::FINALIZATION;
+  Timer::setTimeLimitEnforcement(false);
+  res.updateStatistics();
+
+  exitWithResult();
+} // CLTBProblem::continueAxiomSaturation
 
 /**
  * Return the intended slice time in milliseconds and assign the slice
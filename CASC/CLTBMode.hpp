@@ -37,6 +37,7 @@
 
 #include "Lib/Sys/SyncPipe.hpp"
 
+#include "Kernel/MainLoop.hpp"
 #include "Kernel/Problem.hpp"
 
 #include "Shell/Property.hpp"
@@ -65,7 +66,14 @@ class CLTBMode
 public:
   static void perform();
 private:
+  CLTBMode() : _axiomSaturation(0) {}
+
+  /** exit status of the batch child in which saturateAxioms() failed */
+  static const int AXIOM_SATURATION_FAILED = 2;
+
   void solveBatch(istream& batchFile, bool first,vstring inputDirectory);
+  void solveProblems(vstring inputDirectory,int terminationTime);
+  bool saturateAxioms();
   int readInput(istream& batchFile, bool first);
   static ostream& lineOutput();
   static ostream& coutLineOutput();
@@ -111,6 +119,13 @@ private:
 
   ScopedPtr<Problem> _baseProblem;
 
+  /** preprocessed copy of the included axioms saturated by saturateAxioms() */
+  ScopedPtr<Problem> _saturatedAxioms;
+  /** saturation of _saturatedAxioms problems continue from, 0 if not used */
+  Saturation::SaturationAlgorithm* _axiomSaturation;
+  /** result of the saturation steps run on the axioms */
+  ScopedPtr<MainLoopResult> _axiomSaturationResult;
+
   // This contains formulas 'learned' in the sense that they were input
   // formulas used in proofs of previous problems
   // Note: this relies on the assurance that formulas are consistently named
@@ -137,6 +152,8 @@ private:
   void performStrategy(int terminationTime,int timeLimit,Category category,const Shell::Property* property);
   static void fillSchedule(Schedule& sched,const Shell::Property* property,int timeLimit,Category category);
 
+  void continueAxiomSaturation(UnitList* goalUnits,int terminationTime) __attribute__((noreturn));
+
   void waitForChildAndExitWhenProofFound();
   void exitOnNoSuccess() __attribute__((noreturn));
 
@@ -144,6 +161,7 @@ private:
   static void terminatingSignalHandler(int sigNum) __attribute__((noreturn));
   void runSlice(vstring slice, unsigned milliseconds) __attribute__((noreturn));
   void runSlice(Options& strategyOpt) __attribute__((noreturn));
+  void exitWithResult() __attribute__((noreturn));
 
   static vstring problemFinishedString;
 
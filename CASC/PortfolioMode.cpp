@@ -62,13 +62,19 @@ PortfolioMode::PortfolioMode() : _slowness(1.0), _syncSemaphore(2) {
 /**
  * The function that does all the job: reads the input files and runs
  * Vampires to solve problems.
+ *
+ * If @b prb is given, it is solved instead of the input problem and
+ * the portfolio takes ownership of it.
  */
-bool PortfolioMode::perform(float slowness)
+bool PortfolioMode::perform(float slowness, Problem* prb)
 {
   CALL("PortfolioMode::perform");
 
   PortfolioMode pm;
   pm._slowness = slowness;
+  if (prb) {
+    pm._prb = prb;
+  }
 
   bool resValue;
   try {
@@ -116,7 +122,9 @@ bool PortfolioMode::searchForProof()
   env.timer->makeChildrenIncluded();
   TimeCounter::reinitialize();
 
-  _prb = UIHelper::getInputProblem(*env.options);
+  if (!_prb) {
+    _prb = UIHelper::getInputProblem(*env.options);
+  }
 
   /* CAREFUL: Make sure that the order
    * 1) getProperty, 2) normalise, 3) TheoryFinder::search
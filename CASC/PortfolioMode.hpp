@@ -74,7 +74,7 @@ class PortfolioMode {
   PortfolioMode();
   friend void PortfolioSliceExecutor::runSlice(vstring sliceCode, int terminationTime);
 public:
-  static bool perform(float slowness);
+  static bool perform(float slowness, Problem* prb = 0);
   unsigned getSliceTime(vstring sliceCode,vstring& chopped);
 
 private:
@@ -0,0 +1,129 @@
+
+/*
+ * File ServerMode.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file ServerMode.cpp
+ * Implements class ServerMode.
+ */
+
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+#include "Lib/Environment.hpp"
+#include "Lib/Exception.hpp"
+#include "Lib/System.hpp"
+#include "Lib/Timer.hpp"
+
+#include "Lib/Sys/Multiprocessing.hpp"
+
+#include "Shell/Options.hpp"
+#include "Shell/UIHelper.hpp"
+
+#include "PortfolioMode.hpp"
+
+#include "ServerMode.hpp"
+
+using namespace CASC;
+using namespace std;
+using namespace Lib::Sys;
+using namespace Shell;
+
+void ServerMode::perform()
+{
+  CALL("ServerMode::perform");
+
+  if (env.options->inputFile() == "") {
+    USER_ERROR("Input file must be specified for server mode");
+  }
+
+  ServerMode sm;
+  sm._axioms = UIHelper::getInputProblem(*env.options);
+  // scan the axioms now, the problems then only add their own units to the property
+  sm._axioms->getProperty();
+
+  // the server waits for problems as long as there are any
+  Timer::setTimeLimitEnforcement(false);
+
+  vstring line;
+  while (getline(cin, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    sm.solve(line);
+  }
+}
+
+/**
+ * Solve the problem in @b problemFile together with the axioms in a child process
+ */
+void ServerMode::solve(const vstring& problemFile)
+{
+  CALL("ServerMode::solve");
+
+  env.beginOutput();
+  env.out() << "% SZS status Started for " << problemFile << endl << flush;
+  env.endOutput();
+
+  pid_t child = Multiprocessing::instance()->fork();
+  if (!child) {
+    System::registerForSIGHUPOnParentDeath();
+
+    // On exit, the buffered standard input would move the file offset it
+    // shares with the server back to what this process read.
+    int devNull = open("/dev/null", O_RDONLY);
+    if (devNull != -1) {
+      dup2(devNull, 0);
+      close(devNull);
+    }
+
+    env.timer->reset();
+    env.timer->start();
+    Timer::setTimeLimitEnforcement(true);
+
+    bool solved = false;
+    try {
+      env.options->setInputFile(problemFile);
+      ScopedPtr<Problem> query(UIHelper::getInputProblem(*env.options));
+      UnitList* units = query->units();
+      query->units() = UnitList::empty();
+      Problem* prb = _axioms->copy();
+      prb->addUnits(units);
+      solved = PortfolioMode::perform(1.0, prb);
+    }
+    catch (Exception& exc) {
+      env.beginOutput();
+      exc.cry(env.out());
+      env.endOutput();
+    }
+    System::terminateImmediately(solved ? 0 : 1);
+  }
+
+  int resValue;
+  try {
+    ALWAYS(Multiprocessing::instance()->waitForChildTermination(resValue) == child);
+  }
+  catch (SystemFailException& ex) {
+    cerr << "% SystemFailException at server level" << endl;
+    ex.cry(cerr);
+  }
+
+  env.beginOutput();
+  env.out() << "% SZS status Ended for " << problemFile << endl << flush;
+  env.endOutput();
+}
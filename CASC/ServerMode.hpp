@@ -0,0 +1,63 @@
+
+/*
+ * File ServerMode.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file ServerMode.hpp
+ * Defines class ServerMode.
+ */
+
+#ifndef __ServerMode__
+#define __ServerMode__
+
+#include "Forwards.hpp"
+
+#include "Lib/ScopedPtr.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Problem.hpp"
+
+namespace CASC {
+
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * Mode answering many problems over the same axioms.
+ *
+ * The input file is parsed once and its property computed. Then every
+ * line of the standard input names a problem file, which is solved together
+ * with the input file by the portfolio in a child process forked from
+ * the loaded state, so that the axioms are not parsed again for each
+ * problem. Each problem gets the whole time limit. Its output is framed by
+ * the SZS Started and Ended lines.
+ */
+class ServerMode
+{
+public:
+  static void perform();
+
+private:
+  void solve(const vstring& problemFile);
+
+  /** the parsed input file, shared by all the problems */
+  ScopedPtr<Problem> _axioms;
+};
+
+}
+
+#endif // __ServerMode__
@@ -46,11 +46,11 @@ extern const char* VERSION_STRING;
 using namespace std;
 using namespace Debug;
 
-const char* Tracer::_lastControlPoint;
-Tracer* Tracer::_current = 0;
-unsigned Tracer::_depth = 0;
-unsigned Tracer::_passedControlPoints = 0L;
-ControlPointKind Tracer::_lastPointKind = CP_MID;
+thread_local const char* Tracer::_lastControlPoint;
+thread_local Tracer* Tracer::_current = 0;
+thread_local unsigned Tracer::_depth = 0;
+thread_local unsigned Tracer::_passedControlPoints = 0L;
+thread_local ControlPointKind Tracer::_lastPointKind = CP_MID;
 bool Tracer::_forced = false;
 
 /** This variable is needed when all changes in the value of an
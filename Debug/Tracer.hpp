@@ -70,16 +70,17 @@ class Tracer {
   static void printStackRec (Tracer* current, ostream&, int& depth);
   static void spaces(ostream& str,int number);
 
+  // the trace is kept per thread, see Lib::Sys::WorkerThreads
   /** current trace point */
-  static Tracer* _current;
+  static thread_local Tracer* _current;
   /** current depth */
-  static unsigned _depth;
+  static thread_local unsigned _depth;
   /** description of the last control point (function name) */
-  static const char* _lastControlPoint;
+  static thread_local const char* _lastControlPoint;
   /** total number of passed control points */
-  static unsigned _passedControlPoints;
+  static thread_local unsigned _passedControlPoints;
   /** kind of the last point */
-  static ControlPointKind _lastPointKind;
+  static thread_local ControlPointKind _lastPointKind;
   /** forced by startTrace */
   static bool _forced;
   static void controlPoint (const char*, ControlPointKind);
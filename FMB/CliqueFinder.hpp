@@ -34,6 +34,18 @@ namespace FMB {
     {
       CALL("FMB::CliqueFinder::findMaxCliqueSize");
 
+      Stack<unsigned> clique;
+      return findMaxClique(Ngraph,clique);
+    }
+
+    // As findMaxCliqueSize but also puts the members of the found clique into @b clique
+    // (which stays empty if no clique larger than 1 was found)
+    static unsigned findMaxClique(DHMap<unsigned,DHSet<unsigned>*>* Ngraph, Stack<unsigned>& clique)
+    {
+      CALL("FMB::CliqueFinder::findMaxClique");
+
+      clique.reset();
+
       //cout << "findMaxCliqueSize with " << Ngraph->size() << endl;
 
       // at least stores the number of nodes with at least index neighbours
@@ -64,6 +76,7 @@ namespace FMB {
           if(checkClique(Ngraph,atleast[i])){
             //cout << "FIND(A) max clique of " << (i+1) << endl;
             //for(unsigned j=0;j<atleast[i].size();j++){ cout << atleast[i][j] << " ";}; cout << endl;
+            clique = atleast[i];
             return i+1;
           }
         }
@@ -78,13 +91,13 @@ namespace FMB {
             //cout << ">> " << c << endl;
             auto ns = Ngraph->get(c);
             if(ns->size()==i){
-              Stack<unsigned> clique;
               clique.loadFromIterator(ns->iterator());
               clique.push(c);
               if(checkClique(Ngraph,clique)){
                 //cout << "FIND(B) max clique of " << (i+1) << endl;
                 return i+1;
               }
+              clique.reset();
               left--;
             }
           }
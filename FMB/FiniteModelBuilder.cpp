@@ -26,6 +26,10 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include "Kernel/Ordering.hpp"
 #include "Kernel/Inference.hpp"
@@ -41,6 +45,7 @@
 
 #include "SAT/Preprocess.hpp"
 #include "SAT/TWLSolver.hpp"
+#include "SAT/MinisatInterfacing.hpp"
 #include "SAT/MinisatInterfacingNewSimp.hpp"
 #include "SAT/BufferedSolver.hpp"
 
@@ -53,6 +58,8 @@
 #include "Lib/Random.hpp"
 #include "Lib/DHSet.hpp"
 #include "Lib/ArrayMap.hpp"
+#include "Lib/Sys/WorkerThreads.hpp"
+#include "Lib/Sys/Multiprocessing.hpp"
 
 #include "Shell/UIHelper.hpp"
 #include "Shell/TPTPPrinter.hpp"
@@ -80,6 +87,8 @@
 namespace FMB 
 {
 
+using namespace Lib::Sys;
+
 FiniteModelBuilder::FiniteModelBuilder(Problem& prb, const Options& opt)
 : MainLoop(prb, opt), _sortedSignature(0), _groundClauses(0), _clauses(0),
                       _isAppropriate(true)
@@ -115,6 +124,7 @@ FiniteModelBuilder::FiniteModelBuilder(Problem& prb, const Options& opt)
   // Record option values
   _startModelSize = opt.fmbStartSize();
   _symmetryRatio = opt.fmbSymmetryRatio();
+  _generationWorkers = WorkerThreads::workerCount(opt.fmbGenerationThreads());
 
   // Load any symbols removed during preprocessing (and their definitions)
   _deletedFunctions.loadFromMap(prb.getEliminatedFunctions());
@@ -145,6 +155,13 @@ FiniteModelBuilder::FiniteModelBuilder(Problem& prb, const Options& opt)
     default:
       ASSERTION_VIOLATION;
   }
+
+  // the contour encoding is what makes the constraints for a smaller size valid for the larger ones
+  _incremental = _xmass && opt.fmbIncremental();
+  _groundClausesAdded = false;
+  _symmetrySelector = 0;
+
+  _sizeWorkers = WorkerThreads::workerCount(opt.fmbSizeWorkers());
 }
 
 FiniteModelBuilder::~FiniteModelBuilder()
@@ -164,6 +181,112 @@ FiniteModelBuilder::~FiniteModelBuilder()
 bool FiniteModelBuilder::reset(){
   CALL("FiniteModelBuilder::reset");
 
+  _sortEncodingSizes.ensure(_sortedSignature->sorts);
+  _distinctSortEncodingSizes.ensure(_sortedSignature->distinctSorts);
+
+  if (_incremental) {
+    bool fits = !_solver.isEmpty();
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      if (_distinctSortSizes[i] > _distinctSortEncodingSizes[i]) {
+        fits = false;
+      }
+    }
+    if (fits) {
+      // keep the solver and everything already added to it
+      createSymmetryOrdering();
+      return true;
+    }
+    // leave room for the next few sizes so that the layout does not change too often
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      unsigned room = max(_distinctSortSizes[i],2*_distinctSortEncodingSizes[i]);
+      _distinctSortEncodingSizes[i] = max(_distinctSortSizes[i],min(room,_distinctSortMaxs[i]));
+    }
+  } else {
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      _distinctSortEncodingSizes[i] = _distinctSortSizes[i];
+    }
+  }
+  for(unsigned s=0;s<_sortedSignature->sorts;s++) {
+    _sortEncodingSizes[s] = _distinctSortEncodingSizes[_sortedSignature->parents[s]];
+  }
+
+  unsigned offsets;
+  if (!computeOffsets(offsets)) {
+    if (!_incremental) {
+      return false;
+    }
+    // fall back to the exact sizes, the next size will then need a reset again
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      _distinctSortEncodingSizes[i] = _distinctSortSizes[i];
+    }
+    for(unsigned s=0;s<_sortedSignature->sorts;s++) {
+      _sortEncodingSizes[s] = _sortModelSizes[s];
+    }
+    if (!computeOffsets(offsets)) {
+      return false;
+    }
+  }
+
+  // Create a new SAT solver
+  try{
+    if (_incremental) {
+      // clauses are added between the calls, so variable elimination cannot be used
+      _solver = new MinisatInterfacing(_opt,true);
+    } else {
+      _solver = new MinisatInterfacingNewSimp(_opt,true);
+    }
+  }catch(Minisat::OutOfMemoryException&){
+    MinisatInterfacingNewSimp::reportMinisatOutOfMemory();
+  }
+
+  /*
+  if(_opt.satSolver() != Options::SatSolver::MINISAT){
+    cout << "Warning: overriding sat solver for FMB, using minisat" << endl;
+  }
+  */
+/*
+  switch(_opt.satSolver()){
+    case Options::SatSolver::VAMPIRE:
+      _solver = new TWLSolver(_opt, true);
+      break;
+#if VZ3
+    case Options::SatSolver::Z3:
+        ASSERTION_VIOLATION_REP("Do not use fmb with Z3");
+#endif
+    case Options::SatSolver::MINISAT:
+        try{
+          _solver = new MinisatInterfacingNewSimp(_opt,true);
+        }catch(Minisat::OutOfMemoryException&){
+          MinisatInterfacingNewSimp::reportMinisatOutOfMemory();
+        }
+      break;
+    default:
+      ASSERTION_VIOLATION_REP(_opt.satSolver());
+  }
+*/
+
+  // set the number of SAT variables, this could cause an exception
+  _solver->ensureVarCount(offsets-1);
+
+  if (_incremental) {
+    // nothing has been added to the new solver yet
+    _generatedSortSizes.init(_sortedSignature->sorts,0);
+    _generatedDistinctSortSizes.init(_sortedSignature->distinctSorts,0);
+    _groundClausesAdded = false;
+    _symmetrySelector = 0;
+  }
+
+  // needs to be redone for each size as we use this to pick the number of
+  // things to order and the constants to ground with 
+  createSymmetryOrdering();
+
+  return true;
+}
+
+bool FiniteModelBuilder::computeOffsets(unsigned& offsets)
+{
+  CALL("FiniteModelBuilder::computeOffsets");
+
   // Construct the offsets for symbols
   // Each symbol requires size^n) variables where n is the number of spaces for grounding
   // For function symbols we have n=arity+1 as we have the return value
@@ -176,7 +299,7 @@ bool FiniteModelBuilder::reset(){
   static const unsigned VAR_MAX = MinisatInterfacingNewSimp::VAR_MAX;
 
   // Start from 1 as SAT solver variables are 1-based
-  unsigned offsets=1;
+  offsets=1;
   for(unsigned f=0; f<env.signature->functions();f++){
     if(del_f[f]) continue; 
     f_offsets[f]=offsets;
@@ -187,9 +310,13 @@ bool FiniteModelBuilder::reset(){
     DArray<unsigned> f_signature = _sortedSignature->functionSignatures[f];
     ASS(f_signature.size() == env.signature->functionArity(f)+1);
 
-    unsigned add = _sortModelSizes[f_signature[0]]; 
+    unsigned add = _sortEncodingSizes[f_signature[0]]; 
     for(unsigned i=1;i<f_signature.size();i++){
-      add *= _sortModelSizes[f_signature[i]];
+      // Check that we do not overflow
+      if(VAR_MAX / _sortEncodingSizes[f_signature[i]] < add){
+        return false;
+      }
+      add *= _sortEncodingSizes[f_signature[i]];
     }
 
     // Check that we do not overflow
@@ -211,7 +338,11 @@ bool FiniteModelBuilder::reset(){
     ASS(p_signature.size()==env.signature->predicateArity(p));
     unsigned add=1;
     for(unsigned i=0;i<p_signature.size();i++){
-      add *= _sortModelSizes[p_signature[i]];
+      // Check for overflow
+      if(VAR_MAX / _sortEncodingSizes[p_signature[i]] < add){
+        return false;
+      }
+      add *= _sortEncodingSizes[p_signature[i]];
     }
 
     // Check for overflow
@@ -228,7 +359,7 @@ bool FiniteModelBuilder::reset(){
   if (_xmass) {
     marker_offsets.ensure(_distinctSortSizes.size());
     for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-      unsigned add = _distinctSortSizes[i];
+      unsigned add = _distinctSortEncodingSizes[i];
 
       marker_offsets[i] = offsets;
 
@@ -261,46 +392,6 @@ bool FiniteModelBuilder::reset(){
     offsets += add;
   }
 
-  // Create a new SAT solver
-  try{
-    _solver = new MinisatInterfacingNewSimp(_opt,true);
-  }catch(Minisat::OutOfMemoryException&){
-    MinisatInterfacingNewSimp::reportMinisatOutOfMemory();
-  }
-
-  /*
-  if(_opt.satSolver() != Options::SatSolver::MINISAT){
-    cout << "Warning: overriding sat solver for FMB, using minisat" << endl;
-  }
-  */
-/*
-  switch(_opt.satSolver()){
-    case Options::SatSolver::VAMPIRE:
-      _solver = new TWLSolver(_opt, true);
-      break;
-#if VZ3
-    case Options::SatSolver::Z3:
-        ASSERTION_VIOLATION_REP("Do not use fmb with Z3");
-#endif
-    case Options::SatSolver::MINISAT:
-        try{
-          _solver = new MinisatInterfacingNewSimp(_opt,true);
-        }catch(Minisat::OutOfMemoryException&){
-          MinisatInterfacingNewSimp::reportMinisatOutOfMemory();
-        }
-      break;
-    default:
-      ASSERTION_VIOLATION_REP(_opt.satSolver());
-  }
-*/
-
-  // set the number of SAT variables, this could cause an exception
-  _solver->ensureVarCount(offsets-1);
-
-  // needs to be redone for each size as we use this to pick the number of
-  // things to order and the constants to ground with 
-  createSymmetryOrdering();
-
   return true;
 }
 
@@ -329,10 +420,19 @@ void FiniteModelBuilder::createSymmetryOrdering()
     // Remove any previously computed ordering
     _sortedGroundedTerms[s].reset();
 
-    // Add all the constants of that sort
+    // Add the constants fixed by recordSortClique first, in the order of their values
+    for(unsigned c=0;c<_sortCliques[s].length();c++){
+      GroundedTerm g;
+      g.f = _sortCliques[s][c];
+      g.grounding.ensure(0); // no grounding needed
+      _sortedGroundedTerms[s].push(g);
+    }
+
+    // Add all the (other) constants of that sort
     for(unsigned c=0;c<_sortedSignature->sortedConstants[s].length();c++){
       GroundedTerm g;
       g.f = _sortedSignature->sortedConstants[s][c];
+      if(_pinnedValues.get(g.f,0)) continue;
       g.grounding.ensure(0); // no grounding needed
       _sortedGroundedTerms[s].push(g);
       //cout << "Adding " << g.toString()  << " to " << s << endl;
@@ -706,12 +806,17 @@ void FiniteModelBuilder::init()
     }
 
     //_distinctConstants
+    _sortCliques.ensure(_sortedSignature->sorts);
     for(unsigned s=0;s<env.sorts->count();s++){
       if(_distinctConstants[s]!=0){
 
         ASS(_sortedSignature->vampireToDistinct.find(s));
         auto map = _distinctConstants[s];
-        unsigned max = CliqueFinder::findMaxCliqueSize(map);
+        Stack<unsigned> clique;
+        unsigned max = CliqueFinder::findMaxClique(map,clique);
+        if(_opt.fmbCliqueSymmetry()){
+          recordSortClique(clique);
+        }
         Stack<unsigned>* dss = _sortedSignature->vampireToDistinct.get(s);
         Stack<unsigned>::Iterator ds(*dss);
         while(ds.hasNext()){
@@ -922,6 +1027,12 @@ void FiniteModelBuilder::addGroundClauses()
 {
   CALL("FiniteModelBuilder::addGroundClauses");
 
+  // they do not depend on the sizes
+  if(_incremental && _groundClausesAdded) return;
+  _groundClausesAdded = true;
+
+  addCliqueSymmetryAxioms();
+
   // If we don't have any ground clauses don't do anything
   if(!_groundClauses) return;
 
@@ -946,6 +1057,66 @@ void FiniteModelBuilder::addGroundClauses()
   }
 }
 
+/**
+ * Any model can be permuted so that the pairwise distinct constants of @b clique
+ * are the elements 1,2,...,n of their sort. Record this so that the constants
+ * come first in the symmetry ordering (which keeps the other symmetry axioms valid)
+ * and can be fixed before the instances are generated.
+ */
+void FiniteModelBuilder::recordSortClique(const Stack<unsigned>& clique)
+{
+  CALL("FiniteModelBuilder::recordSortClique");
+
+  if(clique.size()<2) return;
+
+  // the constants were distinct in the input, but some could have been eliminated since
+  // and they could (in theory) have ended up in different inferred sorts
+  unsigned srt = UINT_MAX;
+  for(unsigned i=0;i<clique.size();i++){
+    unsigned c = clique[i];
+    if(c>=del_f.size() || del_f[c] || c>=_sortedSignature->functionSignatures.size()) continue;
+    unsigned csrt = _sortedSignature->functionSignatures[c][0];
+    if(srt==UINT_MAX){
+      srt = csrt;
+    }
+    else if(srt!=csrt){
+      return;
+    }
+  }
+  if(srt==UINT_MAX || !_sortCliques[srt].isEmpty()) return;
+
+  for(unsigned i=0;i<clique.size();i++){
+    unsigned c = clique[i];
+    if(c>=del_f.size() || del_f[c] || c>=_sortedSignature->functionSignatures.size()) continue;
+    if(_sortCliques[srt].size()>=_sortedSignature->sortBounds[srt]) break;
+    _sortCliques[srt].push(c);
+    _pinnedValues.insert(c,_sortCliques[srt].size());
+  }
+#if VTRACE_FMB
+  cout << "Fixed " << _sortCliques[srt].size() << " distinct constants of sort " << srt << endl;
+#endif
+}
+
+/**
+ * Add the unit clauses c=i for the constants fixed by recordSortClique
+ */
+void FiniteModelBuilder::addCliqueSymmetryAxioms()
+{
+  CALL("FiniteModelBuilder::addCliqueSymmetryAxioms");
+
+  static DArray<unsigned> grounding(1);
+  static SATLiteralStack satClauseLits;
+  DHMap<unsigned,unsigned>::Iterator pit(_pinnedValues);
+  while(pit.hasNext()){
+    unsigned c, value;
+    pit.next(c,value);
+    grounding[0] = value;
+    satClauseLits.reset();
+    satClauseLits.push(getSATLiteral(c,grounding,true,true));
+    addSATClause(SATClause::fromStack(satClauseLits));
+  }
+}
+
 // uses _distinctSortSizes to estimate how many instances would we generate
 unsigned FiniteModelBuilder::estimateInstanceCount()
 {
@@ -977,31 +1148,39 @@ void FiniteModelBuilder::addNewInstances()
 {
   CALL("FiniteModelBuilder::addNewInstances");
 
-  ClauseList::Iterator cit(_clauses); 
+  addGeneratedClauses(0,_funcDefTasksStart);
+}
+
+/**
+ * With _incremental, return true if all the values of @b grounding are within
+ * the bounds of the previous round, i.e. the constraint for it is already in the solver
+ */
+static bool isOldGrounding(const DArray<unsigned>& grounding, const DArray<unsigned>& prevVarSize, unsigned len)
+{
+  for(unsigned var=0;var<len;var++){
+    if(grounding[var] > prevVarSize[var]){
+      return false;
+    }
+  }
+  return true;
+}
+
+void FiniteModelBuilder::generateInstances(Clause* c, const DArray<unsigned>& varSorts,
+                                           GenerationScratch& scratch, GroundingBuffer& out)
+{
+  CALL("FiniteModelBuilder::generateInstances");
 
-  while(cit.hasNext()){
-    Clause* c = cit.next();
-    ASS(c);
 #if VTRACE_FMB
     cout << "Instances of " << c->toString() << endl;
 #endif
 
     unsigned vars = c->varCnt();
-    const DArray<unsigned>* varSorts = _clauseVariableSorts.get(c) ;
-    static DArray<unsigned> maxVarSize;
+    DArray<unsigned>& maxVarSize = scratch.maxVarSize;
     maxVarSize.ensure(vars);
+    DArray<unsigned>& prevVarSize = scratch.prevVarSize;
+    prevVarSize.ensure(vars);
 
-    if(!varSorts){
-      // this means that the clause consists only of variable equalities
-      // earlier we ensured that such clauses have at least one positive
-      // variable equality, therefore they can always be satisfied
-      // so we skip this clause 
-      // TODO should it be removed earlier?
-      continue;
-    }
-    ASS(varSorts);
-
-    static ArrayMap<unsigned> varDistinctSortsMaxes(_distinctSortSizes.size());
+    ArrayMap<unsigned>& varDistinctSortsMaxes = scratch.varDistinctSortsMaxes;
 
     if (!_xmass) {
       varDistinctSortsMaxes.reset();
@@ -1009,10 +1188,11 @@ void FiniteModelBuilder::addNewInstances()
 
     //cout << "maxVarSizes "<<endl;;
     for(unsigned var=0;var<vars;var++) {
-      unsigned srt = (*varSorts)[var];
+      unsigned srt = varSorts[var];
       //cout << "srt="<<srt;
       maxVarSize[var] = min(_sortModelSizes[srt],_sortedSignature->sortBounds[srt]);
       //cout << ",max="<<maxVarSize[var] << endl;
+      prevVarSize[var] = _incremental ? min(_generatedSortSizes[srt],_sortedSignature->sortBounds[srt]) : 0;
 
       if (!_xmass) {
         unsigned dsort = _sortedSignature->parents[srt];
@@ -1022,7 +1202,7 @@ void FiniteModelBuilder::addNewInstances()
       }
     }
     
-    static DArray<unsigned> grounding;
+    DArray<unsigned>& grounding = scratch.grounding;
     grounding.ensure(vars);
 
     for(unsigned i=0;i<vars;i++) grounding[i]=1;
@@ -1037,15 +1217,17 @@ instanceLabel:
       } 
       else{
         grounding[var]++;
+        if(_incremental && isOldGrounding(grounding,prevVarSize,vars)){
+          goto instanceLabel;
+        }
         // Grounding represents a new instance
-        static SATLiteralStack satClauseLits;
-        satClauseLits.reset();
+        out.startClause();
 
         if (_xmass) {
           varDistinctSortsMaxes.reset();
           for(unsigned var=0;var<vars;var++) {
             // cout << " var" << var;
-            unsigned srt = (*varSorts)[var];
+            unsigned srt = varSorts[var];
             // cout << " srt" << srt;
             unsigned dsr = _sortedSignature->parents[srt];
             // cout << " dsr" << dsr;
@@ -1071,14 +1253,14 @@ instanceLabel:
 
             if (val > 1) {
               // cout << "Marking sort " << i << " with " << val-2 << " negative" << endl;
-              satClauseLits.push(SATLiteral(marker_offsets[i]+val-2,0));
+              out.push(SATLiteral(marker_offsets[i]+val-2,0));
             }
           }
           // cout << "Clause finised" << endl;
         } else {
           for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
             if (varDistinctSortsMaxes.get(i,0)) {
-              satClauseLits.push(SATLiteral(instancesMarker_offset+i,0));
+              out.push(SATLiteral(instancesMarker_offset+i,0));
             }
           }
         }
@@ -1092,6 +1274,7 @@ instanceLabel:
             bool equal = grounding[lit->nthArgument(0)->var()] == grounding[lit->nthArgument(1)->var()]; 
             if((lit->isPositive() && equal) || (!lit->isPositive() && !equal)){
               //Skip instance
+              out.discardClause();
               goto instanceLabel; 
             } 
             if((lit->isPositive() && !equal) || (!lit->isPositive() && equal)){
@@ -1099,13 +1282,26 @@ instanceLabel:
               continue;
             }
           }
+          DArray<unsigned>& use = scratch.use;
           if(lit->isEquality()){
             ASS(lit->nthArgument(0)->isTerm());
             ASS(lit->nthArgument(1)->isVar());
             Term* t = lit->nthArgument(0)->term();
             unsigned functor = t->functor();
             unsigned arity = t->arity();
-            static DArray<unsigned> use;
+
+            // check cases where the constant is fixed by addCliqueSymmetryAxioms
+            unsigned pinned;
+            if(arity==0 && _pinnedValues.find(functor,pinned)){
+              bool equal = grounding[lit->nthArgument(1)->var()] == pinned;
+              if(lit->isPositive() == equal){
+                //Skip instance
+                out.discardClause();
+                goto instanceLabel;
+              }
+              //Skip literal
+              continue;
+            }
             use.ensure(arity+1);
 
             for(unsigned j=0;j<arity;j++){
@@ -1113,29 +1309,26 @@ instanceLabel:
               use[j] = grounding[t->nthArgument(j)->var()];
             }
             use[arity]=grounding[lit->nthArgument(1)->var()];
-            satClauseLits.push(getSATLiteral(functor,use,lit->polarity(),true));
+            out.push(getSATLiteral(functor,use,lit->polarity(),true));
             
           }else{
             unsigned functor = lit->functor();
             unsigned arity = lit->arity();
-            static DArray<unsigned> use;
             use.ensure(arity);
 
             for(unsigned j=0;j<arity;j++){
               ASS(lit->nthArgument(j)->isVar());
               use[j] = grounding[lit->nthArgument(j)->var()];
             }
-            satClauseLits.push(getSATLiteral(functor,use,lit->polarity(),false));
+            out.push(getSATLiteral(functor,use,lit->polarity(),false));
           }
         }
      
-        SATClause* satCl = SATClause::fromStack(satClauseLits);
-        addSATClause(satCl);
+        out.endClause();
 
         goto instanceLabel;
       }
     }
-  }
 }
 
 // uses _distinctSortSizes to estimate how many instances would we generate
@@ -1172,12 +1365,17 @@ void FiniteModelBuilder::addNewFunctionalDefs()
 {
   CALL("FiniteModelBuilder::addNewFunctionalDefs");
 
+  addGeneratedClauses(_funcDefTasksStart,_totalityTasksStart);
+}
+
+void FiniteModelBuilder::generateFunctionalDefs(unsigned f, GenerationScratch& scratch, GroundingBuffer& out)
+{
+  CALL("FiniteModelBuilder::generateFunctionalDefs");
+
   // For each function f of arity n we add the constraint 
   // f(x1,...,xn) != y | f(x1,...,xn) != z 
   // they should be instantiated with groundings where y!=z
 
-  for(unsigned f=0;f<env.signature->functions();f++){
-    if(del_f[f]) continue;
     unsigned arity = env.signature->functionArity(f);
 
 #if VTRACE_FMB
@@ -1185,21 +1383,26 @@ void FiniteModelBuilder::addNewFunctionalDefs()
 #endif
 
     const DArray<unsigned>& f_signature = _sortedSignature->functionSignatures[f];
-    static DArray<unsigned> maxVarSize;
+    DArray<unsigned>& maxVarSize = scratch.maxVarSize;
     maxVarSize.ensure(arity+2);
+    DArray<unsigned>& prevVarSize = scratch.prevVarSize;
+    prevVarSize.ensure(arity+2);
 
     // find max size of y and z 
     unsigned returnSrt = f_signature[arity];
     maxVarSize[0] = min(_sortedSignature->sortBounds[returnSrt],_sortModelSizes[returnSrt]);
     maxVarSize[1] = min(_sortedSignature->sortBounds[returnSrt],_sortModelSizes[returnSrt]);
+    prevVarSize[0] = _incremental ? min(_sortedSignature->sortBounds[returnSrt],_generatedSortSizes[returnSrt]) : 0;
+    prevVarSize[1] = prevVarSize[0];
 
     // we skip 0 and 1 as these are y and z
     for(unsigned var=2;var<arity+2;var++){
       unsigned srt = f_signature[var-2]; // f_signature[arity] is return sort
       maxVarSize[var] = min(_sortedSignature->sortBounds[srt],_sortModelSizes[srt]);
+      prevVarSize[var] = _incremental ? min(_sortedSignature->sortBounds[srt],_generatedSortSizes[srt]) : 0;
     }
 
-    static DArray<unsigned> grounding;
+    DArray<unsigned>& grounding = scratch.grounding;
     grounding.ensure(arity+2);
     for(unsigned var=0;var<arity+2;var++){ grounding[var]=1; }
     grounding[arity+1]=0;
@@ -1221,27 +1424,27 @@ newFuncLabel:
             //Skip this instance
             goto newFuncLabel;
           }
-          static SATLiteralStack satClauseLits;
-          satClauseLits.reset();
+          if(_incremental && isOldGrounding(grounding,prevVarSize,arity+2)){
+            goto newFuncLabel;
+          }
+          out.startClause();
 
           // grounding is of the form [y,z,x1,x2,...]
           // but use wants to be of the form use[x1,x2,...,y] and use[x1,x2,....,z]
           // so need to do some moving around!
           // btw we put y and z at the front so we can do the symmetry trick above
-          static DArray<unsigned> use;
+          DArray<unsigned>& use = scratch.use;
           use.ensure(arity+1);
           for(unsigned k=0;k<arity;k++) use[k]=grounding[k+2];
           use[arity]=grounding[0];
-          satClauseLits.push(getSATLiteral(f,use,false,true)); 
+          out.push(getSATLiteral(f,use,false,true)); 
           use[arity]=grounding[1];
-          satClauseLits.push(getSATLiteral(f,use,false,true)); 
+          out.push(getSATLiteral(f,use,false,true)); 
 
-          SATClause* satCl = SATClause::fromStack(satClauseLits);
-          addSATClause(satCl);
+          out.endClause();
           goto newFuncLabel;
         }
       }
-  }
 }
 
 void FiniteModelBuilder::addNewSymmetryOrderingAxioms(unsigned size,
@@ -1270,6 +1473,9 @@ void FiniteModelBuilder::addNewSymmetryOrderingAxioms(unsigned size,
     SATLiteral sl = getSATLiteral(gt.f,grounding,true,true);
     satClauseLits.push(sl);
   }
+  if(_symmetrySelector){
+    satClauseLits.push(SATLiteral(_symmetrySelector,0));
+  }
   SATClause* satCl = SATClause::fromStack(satClauseLits);
   addSATClause(satCl);
 
@@ -1316,11 +1522,50 @@ void FiniteModelBuilder::addNewSymmetryCanonicityAxioms(unsigned size,
 
         satClauseLits.push(getSATLiteral(gtj.f,grounding_j,true,true));
       }
+      if(_symmetrySelector){
+        satClauseLits.push(SATLiteral(_symmetrySelector,0));
+      }
       addSATClause(SATClause::fromStack(satClauseLits));
   }
 
 }
 
+/**
+ * With _incremental, retire the symmetry axioms of the previous round and
+ * create a fresh variable to guard those of the current one.
+ * (The grounded terms they are about are chosen anew for each size, so the
+ * axioms of different sizes cannot be combined.)
+ */
+void FiniteModelBuilder::nextSymmetrySelector()
+{
+  CALL("FiniteModelBuilder::nextSymmetrySelector");
+  ASS(_incremental);
+
+  if(_symmetrySelector){
+    static SATLiteralStack satClauseLits;
+    satClauseLits.reset();
+    satClauseLits.push(SATLiteral(_symmetrySelector,0));
+    addSATClause(SATClause::fromStack(satClauseLits));
+  }
+  _symmetrySelector = _solver->newVar();
+}
+
+/**
+ * With _incremental, remember that the constraints for the current sizes are in the solver
+ */
+void FiniteModelBuilder::recordGeneratedSizes()
+{
+  CALL("FiniteModelBuilder::recordGeneratedSizes");
+  ASS(_incremental);
+
+  for(unsigned s=0;s<_sortedSignature->sorts;s++){
+    _generatedSortSizes[s] = _sortModelSizes[s];
+  }
+  for(unsigned i=0;i<_distinctSortSizes.size();i++){
+    _generatedDistinctSortSizes[i] = _distinctSortSizes[i];
+  }
+}
+
 void FiniteModelBuilder::addUseModelSize(unsigned size)
 {
   CALL("FiniteModelBuilder::addUseModelSize");
@@ -1367,8 +1612,9 @@ void FiniteModelBuilder::addNewTotalityDefs()
   if (_xmass) {
     // make sure to solve the problem of some sorts not growing all the way to _sortModelSizes[srt], because of _sortedSignature->sortBounds[srt]
     for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-      // for every sort
-      for (unsigned j = 0; j < _distinctSortSizes[i]-1; j++) {
+      // for every sort (skipping the clauses already in the solver when incremental)
+      unsigned start = (_incremental && _generatedDistinctSortSizes[i]) ? _generatedDistinctSortSizes[i]-1 : 0;
+      for (unsigned j = start; j < _distinctSortSizes[i]-1; j++) {
         // for every domain size j have clause: not marker(j+1) | marker(j)
         // which says: "d > j+2" -> "d > j+1"
         static SATLiteralStack satClauseLits;
@@ -1381,8 +1627,39 @@ void FiniteModelBuilder::addNewTotalityDefs()
     }
   }
 
-  for(unsigned f=0;f<env.signature->functions();f++){
-    if(del_f[f]) continue;
+  addGeneratedClauses(_totalityTasksStart,_generationTasks.size());
+}
+
+// The contour marker guarding the totality clause that restricts a value to 1..i
+// when the maximal value is maxSize and the distinct sort has size distinctSize
+static unsigned totalityMarkerIdx(unsigned i, unsigned maxSize, unsigned distinctSize)
+{
+  // use the largest marker for the largest version even if it is smaller than the distinct sort size
+  return (i == maxSize) ? distinctSize-1 : i-1;
+}
+
+/**
+ * With _incremental, return true if the totality clause restricting the value to 1..i
+ * for an old grounding (see isOldGrounding) is already in the solver.
+ * The clauses only differ between sizes in the markers and the upper bound on i.
+ */
+bool FiniteModelBuilder::isOldTotalityDef(unsigned i, unsigned retSrt, bool weakestOnly)
+{
+  unsigned dRetSrt = _sortedSignature->parents[retSrt];
+  unsigned maxSize = min(_sortedSignature->sortBounds[retSrt],_sortModelSizes[retSrt]);
+  unsigned prevMaxSize = min(_sortedSignature->sortBounds[retSrt],_generatedSortSizes[retSrt]);
+
+  if(i > prevMaxSize || (weakestOnly && i != prevMaxSize)){
+    return false;
+  }
+  return totalityMarkerIdx(i,prevMaxSize,_generatedDistinctSortSizes[dRetSrt]) ==
+         totalityMarkerIdx(i,maxSize,_distinctSortSizes[dRetSrt]);
+}
+
+void FiniteModelBuilder::generateTotalityDefs(unsigned f, GenerationScratch& scratch, GroundingBuffer& out)
+{
+  CALL("FiniteModelBuilder::generateTotalityDefs");
+
     unsigned arity = env.signature->functionArity(f);
 
 #if VTRACE_FMB
@@ -1390,51 +1667,58 @@ void FiniteModelBuilder::addNewTotalityDefs()
 #endif
 
     const DArray<unsigned>& f_signature = _sortedSignature->functionSignatures[f];
+    DArray<unsigned>& use = scratch.use;
 
     if(arity==0){
       unsigned srt = f_signature[0];
       unsigned dsrt = _sortedSignature->parents[srt];
       unsigned maxSize = min(_sortedSignature->sortBounds[srt],_sortModelSizes[srt]);
+      bool weakestOnly = !_xmass || (_sortedSignature->monotonicSorts[dsrt]);
 
       // cout << "Totality for const " << f << " of sort " << srt << " and max size " << maxSize << endl;
 
-      for (unsigned i = (!_xmass || (_sortedSignature->monotonicSorts[dsrt])) ? maxSize : 1; i <= maxSize; i++) { // just the weakest one, if monotonic
-        static SATLiteralStack satClauseLits;
-        satClauseLits.reset();
+      for (unsigned i = weakestOnly ? maxSize : 1; i <= maxSize; i++) { // just the weakest one, if monotonic
+        if(_incremental && isOldTotalityDef(i,srt,weakestOnly)){
+          continue;
+        }
+        out.startClause();
 
         for(unsigned constant=1;constant<=i;constant++){
-          static DArray<unsigned> use(1);
+          use.ensure(1);
           use[0]=constant;
           SATLiteral slit = getSATLiteral(f,use,true,true);
-          satClauseLits.push(slit);
+          out.push(slit);
         }
         if (_xmass) {
-          unsigned marker_idx = (i == maxSize) ? _distinctSortSizes[dsrt]-1 : i-1; // use the largest marker for the largest version even if it is smaller than _distinctSortSizes[dsrt]
-          satClauseLits.push(SATLiteral(marker_offsets[dsrt] + marker_idx,1));
+          unsigned marker_idx = totalityMarkerIdx(i,maxSize,_distinctSortSizes[dsrt]);
+          out.push(SATLiteral(marker_offsets[dsrt] + marker_idx,1));
           ///cout << "out sort " << dsrt;
           // cout << "  version for size " << i << " marked with " << i-1 << " positive" << endl;
         } else {
-          satClauseLits.push(SATLiteral(totalityMarker_offset+dsrt,0));
+          out.push(SATLiteral(totalityMarker_offset+dsrt,0));
         }
 
-        SATClause* satCl = SATClause::fromStack(satClauseLits);
-        addSATClause(satCl);
+        out.endClause();
       }
 
-      continue;
+      return;
     }
 
-    static DArray<unsigned> maxVarSize;
+    DArray<unsigned>& maxVarSize = scratch.maxVarSize;
     maxVarSize.ensure(arity);
+    DArray<unsigned>& prevVarSize = scratch.prevVarSize;
+    prevVarSize.ensure(arity);
     for(unsigned var=0;var<arity;var++){
       unsigned srt = f_signature[var]; 
       maxVarSize[var] = min(_sortedSignature->sortBounds[srt],_sortModelSizes[srt]);
+      prevVarSize[var] = _incremental ? min(_sortedSignature->sortBounds[srt],_generatedSortSizes[srt]) : 0;
     }
     unsigned retSrt = f_signature[arity];
     unsigned dRetSrt = _sortedSignature->parents[retSrt];
     unsigned maxRtSrtSize = min(_sortedSignature->sortBounds[retSrt],_sortModelSizes[retSrt]);
+    bool weakestOnly = !_xmass || (_sortedSignature->monotonicSorts[dRetSrt]);
 
-    static DArray<unsigned> grounding;
+    DArray<unsigned>& grounding = scratch.grounding;
     grounding.ensure(arity);
     for(unsigned var=0;var<arity;var++){ grounding[var]=1; }
     grounding[arity-1]=0;
@@ -1451,42 +1735,211 @@ newTotalLabel:
           //for(unsigned j=0;j<grounding.size();j++) cout << grounding[j] << " ";
           //cout << endl;
 
-          for (unsigned i = (!_xmass || (_sortedSignature->monotonicSorts[dRetSrt])) ? maxRtSrtSize : 1; i <= maxRtSrtSize; i++) {
-            static SATLiteralStack satClauseLits;
-            satClauseLits.reset();
+          bool oldGrounding = _incremental && isOldGrounding(grounding,prevVarSize,arity);
+
+          for (unsigned i = weakestOnly ? maxRtSrtSize : 1; i <= maxRtSrtSize; i++) {
+            if(oldGrounding && isOldTotalityDef(i,retSrt,weakestOnly)){
+              continue;
+            }
+            out.startClause();
 
             for(unsigned constant=1;constant<=i;constant++) {
-              static DArray<unsigned> use;
               use.ensure(arity+1);
               for(unsigned k=0;k<arity;k++) use[k]=grounding[k];
               use[arity]=constant;
-              satClauseLits.push(getSATLiteral(f,use,true,true));
+              out.push(getSATLiteral(f,use,true,true));
             }
             if (_xmass) {
-              unsigned marker_idx = (i == maxRtSrtSize) ? _distinctSortSizes[dRetSrt]-1 : i-1; // use the largest marker for the largest version even if it is smaller than _distinctSortSizes[dsrt]
-              satClauseLits.push(SATLiteral(SATLiteral(marker_offsets[dRetSrt]+marker_idx,1)));
+              unsigned marker_idx = totalityMarkerIdx(i,maxRtSrtSize,_distinctSortSizes[dRetSrt]);
+              out.push(SATLiteral(SATLiteral(marker_offsets[dRetSrt]+marker_idx,1)));
             } else {
-              satClauseLits.push(SATLiteral(totalityMarker_offset+dRetSrt,0));
+              out.push(SATLiteral(totalityMarker_offset+dRetSrt,0));
             }
-            SATClause* satCl = SATClause::fromStack(satClauseLits);
-            addSATClause(satCl);
+            out.endClause();
           }
           goto newTotalLabel;
         }
       }
+}
+
+void FiniteModelBuilder::GroundingBuffer::grow()
+{
+  CALL("FiniteModelBuilder::GroundingBuffer::grow");
+
+  size_t newCapacity = _capacity ? 2*_capacity : 256;
+  unsigned* newData = static_cast<unsigned*>(realloc(_data,newCapacity*sizeof(unsigned)));
+  if(!newData) {
+    // we may be outside of the main thread, so cannot report this gracefully
+    ASSERTION_VIOLATION_REP("out of memory in FMB clause generation");
+    abort();
   }
+  _data = newData;
+  _capacity = newCapacity;
 }
 
+void FiniteModelBuilder::GroundingBuffer::reset()
+{
+  free(_data);
+  _data = 0;
+  _size = 0;
+  _capacity = 0;
+  _clauseStart = 0;
+}
 
-/*
- * We expect grounding to have [x,y] for predicate p(x,y) and [x,y,z] for function z=f(x,y)
- * i.e. as noted above grounding[arity] should be the return for a function
- *
+/**
+ * Runs the generation tasks, called from the worker threads
  */
-SATLiteral FiniteModelBuilder::getSATLiteral(unsigned f, const DArray<unsigned>& grounding,
-                                                           bool polarity,bool isFunction)
+class FiniteModelBuilder::GenerationJob : public WorkerThreads::Job
 {
-  CALL("FiniteModelBuilder::getSATLiteral");
+public:
+  GenerationJob(FiniteModelBuilder& fmb) : _fmb(fmb) {}
+
+  void run(unsigned task, unsigned worker) override
+  {
+    GenerationTask& t = _fmb._generationTasks[task];
+    _fmb.runGenerationTask(t,_fmb._generationScratch[worker]);
+    t.done = true;
+  }
+private:
+  FiniteModelBuilder& _fmb;
+};
+
+void FiniteModelBuilder::createGenerationTasks()
+{
+  CALL("FiniteModelBuilder::createGenerationTasks");
+
+  unsigned instanceTasks = 0;
+  unsigned maxVars = 0;
+  ClauseList::Iterator cit(_clauses);
+  while(cit.hasNext()){
+    Clause* c = cit.next();
+    if(!_clauseVariableSorts.find(c)){
+      // this means that the clause consists only of variable equalities
+      // earlier we ensured that such clauses have at least one positive
+      // variable equality, therefore they can always be satisfied
+      // so we skip this clause 
+      // TODO should it be removed earlier?
+      continue;
+    }
+    instanceTasks++;
+    maxVars = max(maxVars,c->varCnt());
+  }
+
+  unsigned symbolTasks = 0;
+  unsigned maxArity = 0;
+  for(unsigned f=0;f<env.signature->functions();f++){
+    if(del_f[f]) continue;
+    symbolTasks++;
+    maxArity = max(maxArity,env.signature->functionArity(f));
+  }
+  for(unsigned p=1;p<env.signature->predicates();p++){
+    maxArity = max(maxArity,env.signature->predicateArity(p));
+  }
+
+  _generationTasks.ensure(instanceTasks+2*symbolTasks);
+  _funcDefTasksStart = instanceTasks;
+  _totalityTasksStart = instanceTasks+symbolTasks;
+
+  unsigned idx = 0;
+  cit.reset(_clauses);
+  while(cit.hasNext()){
+    Clause* c = cit.next();
+    const DArray<unsigned>* varSorts = _clauseVariableSorts.get(c,0);
+    if(!varSorts) continue;
+    GenerationTask& t = _generationTasks[idx++];
+    t.kind = GenerationTask::INSTANCES;
+    t.clause = c;
+    t.varSorts = varSorts;
+    t.done = false;
+  }
+  for(unsigned k=0;k<2;k++){
+    for(unsigned f=0;f<env.signature->functions();f++){
+      if(del_f[f]) continue;
+      GenerationTask& t = _generationTasks[idx++];
+      t.kind = k ? GenerationTask::TOTALITY_DEFS : GenerationTask::FUNCTIONAL_DEFS;
+      t.clause = 0;
+      t.varSorts = 0;
+      t.functor = f;
+      t.done = false;
+    }
+  }
+  ASS_EQ(idx,_generationTasks.size());
+
+  // the scratch arrays must never grow inside a worker
+  _generationScratch.ensure(_generationWorkers);
+  for(unsigned w=0;w<_generationWorkers;w++){
+    GenerationScratch& scratch = _generationScratch[w];
+    scratch.maxVarSize.ensure(max(maxVars,maxArity+2));
+    scratch.grounding.ensure(max(maxVars,maxArity+2));
+    scratch.use.ensure(maxArity+1);
+    scratch.varDistinctSortsMaxes.ensure(_sortedSignature->distinctSorts);
+    scratch.prevVarSize.ensure(max(maxVars,maxArity+2));
+  }
+}
+
+void FiniteModelBuilder::runGenerationTask(GenerationTask& task, GenerationScratch& scratch)
+{
+  CALL("FiniteModelBuilder::runGenerationTask");
+
+  switch(task.kind){
+    case GenerationTask::INSTANCES:
+      generateInstances(task.clause,*task.varSorts,scratch,task.output);
+      break;
+    case GenerationTask::FUNCTIONAL_DEFS:
+      generateFunctionalDefs(task.functor,scratch,task.output);
+      break;
+    case GenerationTask::TOTALITY_DEFS:
+      generateTotalityDefs(task.functor,scratch,task.output);
+      break;
+  }
+}
+
+void FiniteModelBuilder::generateGroundings()
+{
+  CALL("FiniteModelBuilder::generateGroundings");
+
+  // with a single worker the tasks are run one by one in addGeneratedClauses,
+  // so that only one output buffer exists at a time
+  if(_generationWorkers<=1) return;
+
+  GenerationJob job(*this);
+  WorkerThreads::run(job,_generationTasks.size(),_generationWorkers);
+}
+
+void FiniteModelBuilder::addGeneratedClauses(unsigned first, unsigned end)
+{
+  CALL("FiniteModelBuilder::addGeneratedClauses");
+
+  static SATLiteralStack satClauseLits;
+  for(unsigned i=first;i<end;i++){
+    GenerationTask& task = _generationTasks[i];
+    if(!task.done){
+      runGenerationTask(task,_generationScratch[0]);
+    }
+    const GroundingBuffer& out = task.output;
+    size_t pos = 0;
+    while(pos<out.size()){
+      unsigned len = out[pos++];
+      satClauseLits.reset();
+      for(unsigned k=0;k<len;k++){
+        satClauseLits.push(SATLiteral(out[pos++]));
+      }
+      addSATClause(SATClause::fromStack(satClauseLits));
+    }
+    task.output.reset();
+    task.done = false;
+  }
+}
+
+/*
+ * We expect grounding to have [x,y] for predicate p(x,y) and [x,y,z] for function z=f(x,y)
+ * i.e. as noted above grounding[arity] should be the return for a function
+ *
+ */
+SATLiteral FiniteModelBuilder::getSATLiteral(unsigned f, const DArray<unsigned>& grounding,
+                                                           bool polarity,bool isFunction)
+{
+  CALL("FiniteModelBuilder::getSATLiteral");
 
   // cannot have predicate 0 here (it's equality)
   ASS(f>0 || isFunction);
@@ -1509,8 +1962,8 @@ SATLiteral FiniteModelBuilder::getSATLiteral(unsigned f, const DArray<unsigned>&
   for(unsigned i=0;i<grounding.size();i++){
     var += mult*(grounding[i]-1);
     unsigned srt = signature[i];
-    //cout << var << ", " << mult << "," << _sortModelSizes[srt] << endl;
-    mult *= _sortModelSizes[srt];
+    //cout << var << ", " << mult << "," << _sortEncodingSizes[srt] << endl;
+    mult *= _sortEncodingSizes[srt];
   }
   //cout << "return " << var << endl;
 
@@ -1530,6 +1983,127 @@ void FiniteModelBuilder::addSATClause(SATClause* cl)
 
 }
 
+/**
+ * Generate the constraints for the current model sizes into _clausesToBeAdded
+ */
+void FiniteModelBuilder::generateConstraints()
+{
+  CALL("FiniteModelBuilder::generateConstraints");
+
+  TimeCounter tc(TC_FMB_CONSTRAINT_CREATION);
+
+  // add the new clauses to _clausesToBeAdded
+#if VTRACE_FMB
+  cout << "GROUND" << endl;
+#endif
+  addGroundClauses();
+  if (_incremental) {
+    nextSymmetrySelector();
+  }
+  generateGroundings();
+#if VTRACE_FMB
+  cout << "INSTANCES" << endl;
+#endif
+  addNewInstances();
+#if VTRACE_FMB
+  cout << "FUNC DEFS" << endl;
+#endif
+  addNewFunctionalDefs();
+#if VTRACE_FMB
+  cout << "SYM DEFS" << endl;
+#endif
+  addNewSymmetryAxioms();
+
+#if VTRACE_FMB
+  cout << "TOTAL DEFS" << endl;
+#endif
+  addNewTotalityDefs();
+
+  if (_incremental) {
+    recordGeneratedSizes();
+  }
+}
+
+/**
+ * Pass the generated clauses to the SAT solver and solve them
+ * under the assumptions selecting the current model sizes
+ */
+SATSolver::Status FiniteModelBuilder::solveCurrentSizes()
+{
+  CALL("FiniteModelBuilder::solveCurrentSizes");
+
+#if VTRACE_FMB
+  cout << "SOLVING" << endl;
+#endif
+  //TODO consider adding clauses directly to SAT solver in new interface?
+  // pass clauses and assumption to SAT Solver
+  {
+    TimeCounter tc(TC_FMB_SAT_SOLVING);
+    _solver->addClausesIter(pvi(SATClauseStack::ConstIterator(_clausesToBeAdded)));
+  }
+
+  env.statistics->phase = Statistics::FMB_SOLVING;
+  TimeCounter tc(TC_FMB_SAT_SOLVING);
+
+  static SATLiteralStack assumptions(_distinctSortSizes.size());
+  assumptions.reset();
+  if (_xmass) {
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      assumptions.push(SATLiteral(marker_offsets[i]+_distinctSortSizes[i]-1,0));
+      // cout << "assuming sort " << i << " value " << _distinctSortSizes[i]-1 << " negative" << endl;
+    }
+    if (_symmetrySelector) {
+      assumptions.push(SATLiteral(_symmetrySelector,1));
+    }
+  } else {
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      assumptions.push(SATLiteral(totalityMarker_offset+i,1));
+    }
+    for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+      assumptions.push(SATLiteral(instancesMarker_offset+i,1));
+    }
+  }
+
+  SATSolver::Status satResult = _solver->solveUnderAssumptions(assumptions);
+  env.statistics->phase = Statistics::FMB_CONSTRAINT_GEN;
+  return satResult;
+}
+
+/**
+ * In the point-wise encoding, turn the failed assumptions of the last
+ * unsuccessful solver call into a nogood on the domain sizes
+ */
+void FiniteModelBuilder::computeNogood(Constraint_Generator_Vals& nogood)
+{
+  CALL("FiniteModelBuilder::computeNogood");
+  ASS(!_xmass);
+
+  const SATLiteralStack& failed = _solver->failedAssumptions();
+
+  nogood.ensure(_distinctSortSizes.size());
+
+  for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+    nogood[i] = make_pair(STAR,_distinctSortSizes[i]);
+  }
+
+  for (unsigned i = 0; i < failed.size(); i++) {
+    unsigned var = failed[i].var();
+    ASS_GE(var,totalityMarker_offset);
+
+    if (var < instancesMarker_offset) { // totality used (-> instances used as well / unless the sort is monotonic)
+      unsigned dsort = var-totalityMarker_offset;
+      if (_sortedSignature->monotonicSorts[dsort]) {
+        nogood[dsort].first = LEQ;
+      } else {
+        nogood[dsort].first = EQ;
+      }
+    } else if (nogood[var-instancesMarker_offset].first == STAR) { // instances used (and we don't know yet about totality)
+      ASS(!_sortedSignature->monotonicSorts[var-instancesMarker_offset]);
+      nogood[var-instancesMarker_offset].first = GEQ;
+    }
+  }
+}
+
 MainLoopResult FiniteModelBuilder::runImpl()
 {
   CALL("FiniteModelBuilder::runImpl");
@@ -1580,6 +2154,12 @@ MainLoopResult FiniteModelBuilder::runImpl()
     }
   }
 
+  createGenerationTasks();
+
+  if (!_xmass && _sizeWorkers > 1) {
+    return runSizeWorkers();
+  }
+
   if (reset()) {
   while(true){
     if(outputAllowed()) {
@@ -1593,68 +2173,9 @@ MainLoopResult FiniteModelBuilder::runImpl()
     Timer::syncClock();
     if(env.timeLimitReached()){ return MainLoopResult(Statistics::TIME_LIMIT); }
 
-    {
-    TimeCounter tc(TC_FMB_CONSTRAINT_CREATION);
-
-    // add the new clauses to _clausesToBeAdded
-#if VTRACE_FMB
-    cout << "GROUND" << endl;
-#endif
-    addGroundClauses();
-#if VTRACE_FMB
-    cout << "INSTANCES" << endl;
-#endif
-    addNewInstances();
-#if VTRACE_FMB
-    cout << "FUNC DEFS" << endl;
-#endif
-    addNewFunctionalDefs();
-#if VTRACE_FMB
-    cout << "SYM DEFS" << endl;
-#endif
-    addNewSymmetryAxioms();
-    
-#if VTRACE_FMB
-    cout << "TOTAL DEFS" << endl;
-#endif
-    addNewTotalityDefs();
-
-    }
-
-#if VTRACE_FMB
-    cout << "SOLVING" << endl;
-#endif
-    //TODO consider adding clauses directly to SAT solver in new interface?
-    // pass clauses and assumption to SAT Solver
-    {
-      TimeCounter tc(TC_FMB_SAT_SOLVING);
-      _solver->addClausesIter(pvi(SATClauseStack::ConstIterator(_clausesToBeAdded)));
-    }
-
-    SATSolver::Status satResult = SATSolver::UNKNOWN;
-    {
-      env.statistics->phase = Statistics::FMB_SOLVING;
-      TimeCounter tc(TC_FMB_SAT_SOLVING);
-
-      static SATLiteralStack assumptions(_distinctSortSizes.size());
-      assumptions.reset();
-      if (_xmass) {
-        for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-          assumptions.push(SATLiteral(marker_offsets[i]+_distinctSortSizes[i]-1,0));
-          // cout << "assuming sort " << i << " value " << _distinctSortSizes[i]-1 << " negative" << endl;
-        }
-      } else {
-        for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-          assumptions.push(SATLiteral(totalityMarker_offset+i,1));
-        }
-        for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-          assumptions.push(SATLiteral(instancesMarker_offset+i,1));
-        }
-      }
+    generateConstraints();
 
-      satResult = _solver->solveUnderAssumptions(assumptions);
-      env.statistics->phase = Statistics::FMB_CONSTRAINT_GEN;
-    }
+    SATSolver::Status satResult = solveCurrentSizes();
 
     // if the clauses are satisfiable then we have found a finite model
     if(satResult == SATSolver::SATISFIABLE){
@@ -1689,6 +2210,11 @@ MainLoopResult FiniteModelBuilder::runImpl()
         for (unsigned i = 0; i < failed.size(); i++) {
           unsigned var = failed[i].var();
 
+          // the symmetry axioms do not tell us which domain to grow
+          if (var == _symmetrySelector) {
+            continue;
+          }
+
           unsigned srt = which_sort(var);
 
           // cout << "which_sort(var) = " << srt << endl;
@@ -1759,28 +2285,7 @@ MainLoopResult FiniteModelBuilder::runImpl()
       } else { // i.e. (!_xmass)
         static Constraint_Generator_Vals nogood;
 
-        nogood.ensure(_distinctSortSizes.size());
-
-        for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
-          nogood[i] = make_pair(STAR,_distinctSortSizes[i]);
-        }
-
-        for (unsigned i = 0; i < failed.size(); i++) {
-          unsigned var = failed[i].var();
-          ASS_GE(var,totalityMarker_offset);
-
-          if (var < instancesMarker_offset) { // totality used (-> instances used as well / unless the sort is monotonic)
-            unsigned dsort = var-totalityMarker_offset;
-            if (_sortedSignature->monotonicSorts[dsort]) {
-              nogood[dsort].first = LEQ;
-            } else {
-              nogood[dsort].first = EQ;
-            }
-          } else if (nogood[var-instancesMarker_offset].first == STAR) { // instances used (and we don't know yet about totality)
-            ASS(!_sortedSignature->monotonicSorts[var-instancesMarker_offset]);
-            nogood[var-instancesMarker_offset].first = GEQ;
-          }
-        }
+        computeNogood(nogood);
 
 #if VTRACE_DOMAINS
         cout << "Learned a nogood: ";
@@ -1834,13 +2339,328 @@ MainLoopResult FiniteModelBuilder::runImpl()
   return MainLoopResult(Statistics::REFUTATION_NOT_FOUND);
 }
 
-void FiniteModelBuilder::onModelFound()
+namespace {
+
+void writeAll(int fd, const vstring& msg)
 {
- CALL("FiniteModelBuilder::onModelFound");
- // Don't do any output if proof is off
- if(_opt.proof()==Options::Proof::OFF){ 
-   return; 
- }
+  const char* data = msg.c_str();
+  size_t left = msg.size();
+  while(left) {
+    ssize_t res = ::write(fd, data, left);
+    if(res == -1) {
+      if(errno == EINTR) continue;
+      // the parent is gone, nobody is listening
+      return;
+    }
+    data += res;
+    left -= res;
+  }
+}
+
+vstring readAll(int fd)
+{
+  vstring res;
+  char buf[4096];
+  for(;;) {
+    ssize_t cnt = ::read(fd, buf, sizeof(buf));
+    if(cnt == -1) {
+      if(errno == EINTR) continue;
+      break;
+    }
+    if(cnt == 0) {
+      break;
+    }
+    res.append(buf, cnt);
+  }
+  return res;
+}
+
+}
+
+/**
+ * Try the domain size assignments of the point-wise encoding in up to
+ * _sizeWorkers child processes at once.
+ *
+ * Each child generates and solves the constraints for one size assignment
+ * and reports back either the model it found or the nogood learned from the
+ * failed assumptions. The nogoods are learned by the _dsaEnumerator of this
+ * process, so every child started later benefits from all of them. A child
+ * already running does not get the nogoods learned after it was started, it
+ * is only stopped when one of them excludes its size assignment. Until a
+ * child reports back, its size assignment is blocked by an exact nogood so
+ * that the enumerator can hand out the next one.
+ */
+MainLoopResult FiniteModelBuilder::runSizeWorkers()
+{
+  CALL("FiniteModelBuilder::runSizeWorkers");
+  ASS(!_xmass);
+
+  Stack<SizeWorker> workers;
+  static Constraint_Generator_Vals nogood;
+  nogood.ensure(_distinctSortSizes.size());
+
+  // the first assignment comes from init, the next ones from the enumerator
+  bool first = true;
+  // set when a child failed without reporting back, in which case running out
+  // of size assignments does not mean there is no model
+  bool incomplete = false;
+  // the enumerator forgets the nogoods it has used up as generators, which
+  // may bring back an assignment whose child has not reported back yet
+  DHSet<vstring> tried;
+  // the exact nogoods get a weight above all the others, so they do not
+  // take over as generators from the real ones (like the artificial children in HackyDSAE)
+  unsigned maxWeight = 0;
+
+  while(true) {
+    while(workers.size() < _sizeWorkers) {
+      if(!first && !_dsaEnumerator->increaseModelSizes(_distinctSortSizes,_distinctSortMaxs)) {
+        break;
+      }
+      first = false;
+
+      for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+        nogood[i] = make_pair(EQ,_distinctSortSizes[i]);
+      }
+      _dsaEnumerator->learnNogood(nogood,++maxWeight);
+
+      vstring key;
+      for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+        key += Int::toString(_distinctSortSizes[i]) + ",";
+      }
+      if(!tried.insert(key)) {
+        continue;
+      }
+
+      for(unsigned s=0;s<_sortedSignature->sorts;s++) {
+        _sortModelSizes[s] = _distinctSortSizes[_sortedSignature->parents[s]];
+      }
+      if(outputAllowed()) {
+        cout << "TRYING " << "[";
+        for(unsigned i=0;i<_distinctSortSizes.size();i++){
+          cout << _distinctSortSizes[i];
+          if(i+1 < _distinctSortSizes.size()) cout << ",";
+        }
+        cout << "]" << endl;
+      }
+
+      startSizeWorker(workers);
+    }
+
+    if(workers.isEmpty()) {
+      break;
+    }
+
+    static DArray<pollfd> pfds;
+    pfds.ensure(workers.size());
+    for(unsigned i=0;i<workers.size();i++) {
+      pfds[i].fd = workers[i].fd;
+      pfds[i].events = POLLIN;
+      pfds[i].revents = 0;
+    }
+    int res = poll(pfds.array(), workers.size(), 100);
+    if(res == -1 && errno != EINTR) {
+      SYSTEM_FAIL("Call to poll() function failed.", errno);
+    }
+
+    Timer::syncClock();
+    if(env.timeLimitReached()) {
+      killSizeWorkers(workers);
+      return MainLoopResult(Statistics::TIME_LIMIT);
+    }
+    if(res <= 0) {
+      continue;
+    }
+
+    unsigned idx = 0;
+    while(!pfds[idx].revents) {
+      idx++;
+    }
+    SizeWorker w = workers[idx];
+    workers[idx] = workers.top();
+    workers.pop();
+
+    // the child writes its whole report and exits
+    vstring msg = readAll(w.fd);
+    close(w.fd);
+    int status;
+    Multiprocessing::instance()->waitForParticularChildTermination(w.pid,status);
+
+    if(msg.empty()) {
+      incomplete = true;
+      continue;
+    }
+    switch(msg[0]) {
+      case 'S':
+        killSizeWorkers(workers);
+        if(_opt.proof()!=Options::Proof::OFF) {
+          announceModel();
+          env.statistics->model = msg.substr(1);
+        }
+        return MainLoopResult(Statistics::SATISFIABLE);
+      case 'R':
+        killSizeWorkers(workers);
+        if(outputAllowed()){
+          cout << "Cannot represent all propositional literals internally" <<endl;
+        }
+        return MainLoopResult(Statistics::REFUTATION_NOT_FOUND);
+      case 'U':
+      {
+        vistringstream str(msg.substr(1));
+        unsigned weight;
+        str >> weight;
+        for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+          unsigned sign;
+          str >> sign >> nogood[i].second;
+          nogood[i].first = static_cast<ConstraintSign>(sign);
+        }
+#if VTRACE_DOMAINS
+        cout << "Learned a nogood: ";
+        output_cg(nogood);
+        cout << " of weight " << weight << endl;
+#endif
+        _dsaEnumerator->learnNogood(nogood,weight);
+        maxWeight = max(maxWeight,weight);
+
+        // the nogood cannot be passed to a running child, but a child
+        // whose sizes it excludes is bound to fail and can be stopped
+        for(unsigned j=0;j<workers.size();) {
+          bool excluded = true;
+          for (unsigned i = 0; excluded && i < _distinctSortSizes.size(); i++) {
+            unsigned size = workers[j].sizes[i];
+            switch(nogood[i].first) {
+              case EQ:
+                excluded = size == nogood[i].second;
+                break;
+              case LEQ:
+                excluded = size <= nogood[i].second;
+                break;
+              case GEQ:
+                excluded = size >= nogood[i].second;
+                break;
+              case STAR:
+                break;
+            }
+          }
+          if(excluded) {
+            killSizeWorker(workers[j]);
+            workers[j] = workers.top();
+            workers.pop();
+          } else {
+            j++;
+          }
+        }
+        break;
+      }
+      default:
+        incomplete = true;
+    }
+  }
+
+  if (!incomplete && _dsaEnumerator->isFmbComplete(_distinctSortSizes.size())) {
+    Clause* empty = new(0) Clause(0,NonspecificInference0(UnitInputType::AXIOM,InferenceRule::MODEL_NOT_FOUND));
+    return MainLoopResult(Statistics::REFUTATION,empty);
+  }
+  if(outputAllowed()) {
+    cout << "Cannot enumerate next child to try in an incomplete setup" <<endl;
+  }
+  return MainLoopResult(Statistics::REFUTATION_NOT_FOUND);
+}
+
+/**
+ * Fork a child trying the current model sizes
+ */
+void FiniteModelBuilder::startSizeWorker(Stack<SizeWorker>& workers)
+{
+  CALL("FiniteModelBuilder::startSizeWorker");
+
+  int fds[2];
+  if(pipe(fds) == -1) {
+    SYSTEM_FAIL("Call to pipe() function failed.", errno);
+  }
+  // what is still in the buffer would be printed by the child as well
+  cout.flush();
+
+  pid_t pid = Multiprocessing::instance()->fork();
+  if(pid == 0) {
+    close(fds[0]);
+    sizeWorkerMain(fds[1]);
+  }
+  close(fds[1]);
+
+  SizeWorker w;
+  w.pid = pid;
+  w.fd = fds[0];
+  for (unsigned i = 0; i < _distinctSortSizes.size(); i++) {
+    w.sizes.push(_distinctSortSizes[i]);
+  }
+  workers.push(w);
+}
+
+void FiniteModelBuilder::killSizeWorker(SizeWorker& w)
+{
+  CALL("FiniteModelBuilder::killSizeWorker");
+
+  Multiprocessing::instance()->killNoCheck(w.pid,SIGKILL);
+  close(w.fd);
+  int status;
+  Multiprocessing::instance()->waitForParticularChildTermination(w.pid,status);
+}
+
+void FiniteModelBuilder::killSizeWorkers(Stack<SizeWorker>& workers)
+{
+  CALL("FiniteModelBuilder::killSizeWorkers");
+
+  while(workers.isNonEmpty()) {
+    killSizeWorker(workers.top());
+    workers.pop();
+  }
+}
+
+/**
+ * The body of a child started by startSizeWorker. Solves for the current model
+ * sizes and reports the result to @b fd as one of
+ * "S" followed by the model (empty when proofs are off),
+ * "U weight sign_1 size_1 ... sign_n size_n" for the nogood learned, or
+ * "R" when the SAT variables cannot be represented.
+ */
+void FiniteModelBuilder::sizeWorkerMain(int fd)
+{
+  CALL("FiniteModelBuilder::sizeWorkerMain");
+
+  // the parent does all the talking
+  env.options->setOutputMode(Options::Output::SMTCOMP);
+  System::registerForSIGHUPOnParentDeath();
+
+  vstring msg;
+  if(!reset()) {
+    msg = "R";
+  }
+  else {
+    generateConstraints();
+    if(solveCurrentSizes() == SATSolver::SATISFIABLE) {
+      // with the output disabled, this only builds the model into env.statistics
+      onModelFound();
+      msg = "S" + env.statistics->model;
+    }
+    else {
+      static Constraint_Generator_Vals nogood;
+      computeNogood(nogood);
+
+      msg = "U " + Int::toString(_clausesToBeAdded.size());
+      for (unsigned i = 0; i < nogood.size(); i++) {
+        msg += " " + Int::toString(nogood[i].first) + " " + Int::toString(nogood[i].second);
+      }
+    }
+  }
+  writeAll(fd,msg);
+  close(fd);
+
+  System::terminateImmediately(0);
+}
+
+void FiniteModelBuilder::announceModel()
+{
+ CALL("FiniteModelBuilder::announceModel");
 
  reportSpiderStatus('-');
  if(outputAllowed()){
@@ -1857,7 +2677,17 @@ void FiniteModelBuilder::onModelFound()
  }
   // Prevent timing out whilst the model is being printed
   Timer::setTimeLimitEnforcement(false);
+}
+
+void FiniteModelBuilder::onModelFound()
+{
+ CALL("FiniteModelBuilder::onModelFound");
+ // Don't do any output if proof is off
+ if(_opt.proof()==Options::Proof::OFF){ 
+   return; 
+ }
 
+ announceModel();
 
  DHMap<unsigned,unsigned> vampireSortSizes;
  for(unsigned vSort=0;vSort<env.sorts->count();vSort++){
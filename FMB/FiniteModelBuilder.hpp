@@ -24,6 +24,8 @@
 #ifndef __FiniteModelBuilder__
 #define __FiniteModelBuilder__
 
+#include <atomic>
+
 #include "Forwards.hpp"
 
 #if VZ3
@@ -36,6 +38,7 @@
 #include "Lib/ScopedPtr.hpp"
 #include "SortInference.hpp"
 #include "Lib/BinaryHeap.hpp"
+#include "Lib/ArrayMap.hpp"
 
 namespace FMB {
 using namespace Lib;
@@ -83,6 +86,28 @@ private:
 
   // Creates the model output
   void onModelFound();
+  // Reports that a model was found (the part of onModelFound before the model is built)
+  void announceModel();
+
+  // Generates the constraints for the current model sizes into _clausesToBeAdded
+  void generateConstraints();
+  // Passes _clausesToBeAdded to the solver and solves for the current model sizes
+  SATSolver::Status solveCurrentSizes();
+
+  // Trying several size assignments of the point-wise encoding at once in child processes
+  struct SizeWorker {
+    pid_t pid;
+    // the read end of the pipe the child reports its result to
+    int fd;
+    // the distinct sort sizes the child is trying
+    Stack<unsigned> sizes;
+  };
+  MainLoopResult runSizeWorkers();
+  void startSizeWorker(Stack<SizeWorker>& workers);
+  void killSizeWorker(SizeWorker& w);
+  void killSizeWorkers(Stack<SizeWorker>& workers);
+  void sizeWorkerMain(int fd);
+  unsigned _sizeWorkers;
 
   // Adds constraints from ground clauses (same constraints for each model size)
   void addGroundClauses();
@@ -100,6 +125,116 @@ private:
   // Add constraints from totality of function symbols in signature (except those removed in preprocessing)
   void addNewTotalityDefs();
 
+  /**
+   * Bytes held by the GroundingBuffers of the generation tasks together and
+   * how many they may hold. Updated from the worker threads.
+   */
+  struct GroundingBudget {
+    std::atomic<size_t> used;
+    size_t limit;
+  };
+
+  /**
+   * The SAT clauses produced by one generation task, each stored as its length
+   * followed by the contents of its literals. The storage is malloc-based as the
+   * buffer may be filled by a worker thread, which must not use the Allocator.
+   *
+   * If the buffer would exceed its budget or malloc fails, it drops its contents
+   * and ignores further pushes; the task then has to be run again or given up.
+   */
+  class GroundingBuffer {
+  public:
+    GroundingBuffer() : _data(0), _size(0), _capacity(0), _clauseStart(0), _failed(false), _budget(0) {}
+    ~GroundingBuffer() { reset(); }
+
+    void setBudget(GroundingBudget* budget) { _budget = budget; }
+
+    void startClause() { _clauseStart = _size; pushRaw(0); }
+    void push(SATLiteral lit) { pushRaw(lit.content()); }
+    void endClause() { if(!_failed) { _data[_clauseStart] = _size-_clauseStart-1; } }
+    // forget the clause started last, used when an instance turns out to be trivial
+    void discardClause() { _size = _clauseStart; }
+
+    // free the memory
+    void reset();
+
+    bool failed() const { return _failed; }
+    size_t size() const { return _size; }
+    unsigned operator[](size_t i) const { return _data[i]; }
+  private:
+    void pushRaw(unsigned val) {
+      if(_size==_capacity && !grow()) { return; }
+      _data[_size++] = val;
+    }
+    bool grow();
+
+    unsigned* _data;
+    size_t _size;
+    size_t _capacity;
+    size_t _clauseStart;
+    bool _failed;
+    GroundingBudget* _budget;
+  };
+
+  // The instances of one clause, or the functionality or totality constraints of one function symbol.
+  // Tasks are independent of each other and can be run in parallel (see generateGroundings)
+  struct GenerationTask {
+    enum Kind {
+      INSTANCES,
+      FUNCTIONAL_DEFS,
+      TOTALITY_DEFS
+    };
+    Kind kind;
+    // the clause to instantiate and the sorts of its variables, for INSTANCES
+    Clause* clause;
+    const DArray<unsigned>* varSorts;
+    // the function symbol, for FUNCTIONAL_DEFS and TOTALITY_DEFS
+    unsigned functor;
+    // true if output has already been filled for the current model size
+    bool done;
+    GroundingBuffer output;
+  };
+
+  // Working arrays of one worker, allocated large enough in advance so that they
+  // never need to grow while a task runs
+  struct GenerationScratch {
+    DArray<unsigned> maxVarSize;
+    DArray<unsigned> grounding;
+    DArray<unsigned> use;
+    ArrayMap<unsigned> varDistinctSortsMaxes;
+    // with _incremental, the bounds of the groundings that are already in the solver
+    DArray<unsigned> prevVarSize;
+  };
+
+  class GenerationJob;
+
+  // Creates the tasks and the per-worker scratch arrays, once before the first model size
+  void createGenerationTasks();
+  // Fills the outputs of a prefix of the tasks in [first,end), at most maxTasks of them, within the budget
+  void generateGroundings(unsigned first, unsigned end, unsigned maxTasks);
+  // Adds the clauses of the tasks in [first,end) in their order
+  void addGeneratedClauses(unsigned first, unsigned end);
+
+  void runGenerationTask(GenerationTask& task, GenerationScratch& scratch);
+  void generateInstances(Clause* c, const DArray<unsigned>& varSorts, GenerationScratch& scratch, GroundingBuffer& out);
+  void generateFunctionalDefs(unsigned f, GenerationScratch& scratch, GroundingBuffer& out);
+  void generateTotalityDefs(unsigned f, GenerationScratch& scratch, GroundingBuffer& out);
+  bool isOldTotalityDef(unsigned i, unsigned retSrt, bool weakestOnly);
+
+  // Tasks are ordered as instances, then functional definitions, then totality definitions.
+  // The ranges of the three kinds are [0,_funcDefTasksStart), [_funcDefTasksStart,_totalityTasksStart)
+  // and [_totalityTasksStart,_generationTasks.size())
+  DArray<GenerationTask> _generationTasks;
+  unsigned _funcDefTasksStart;
+  unsigned _totalityTasksStart;
+  DArray<GenerationScratch> _generationScratch;
+  // the number of threads used to generate the groundings
+  unsigned _generationWorkers;
+  GroundingBudget _groundingBudget;
+  // the most bytes the outputs of several tasks may take together, so that
+  // the groundings are passed on to the solver as they are generated
+  static const size_t MAX_BUFFERED_GROUNDINGS = 64*1024*1024;
+
   // Add constraints for symmetry ordering i.e. the first modelSize groundedTerms are ordered
   void addNewSymmetryOrderingAxioms(unsigned modelSize,Stack<GroundedTerm>& groundedTerms); 
   // Add constraints for canonicity of symmetry order i.e. if a groundedTerm uses a constant smaller terms use smaller constants
@@ -132,12 +267,23 @@ private:
 
   // resets all structures and SAT solver using _sortModelSizes 
   bool reset();
+  // computes the offsets of symbols and markers using _sortEncodingSizes,
+  // returns false if they do not fit into the SAT solver variables
+  bool computeOffsets(unsigned& offsets);
 
   // make the symmetry orderings
   void createSymmetryOrdering();
   // The per-sort ordering of grounded terms used for symmetry breaking
   DArray<Stack<GroundedTerm>> _sortedGroundedTerms;
 
+  // symmetry breaking using cliques of distinct constants (_opt.fmbCliqueSymmetry())
+  void recordSortClique(const Stack<unsigned>& clique);
+  void addCliqueSymmetryAxioms();
+  // per sort, the distinct constants fixed to the values 1,2,...
+  DArray<Stack<unsigned>> _sortCliques;
+  // the value each of the above constants is fixed to
+  DHMap<unsigned,unsigned> _pinnedValues;
+
   // SAT solver used to solve constraints (a new one is used for each model size)
   ScopedPtr<SATSolverWithAssumptions> _solver;
 
@@ -238,6 +384,27 @@ private:
   DArray<unsigned> _sortModelSizes;
   DArray<unsigned> _distinctSortSizes;
 
+  // sizes the SAT variables are laid out for, these are the same as the model sizes
+  // unless _incremental, in which case they are (usually) larger so that the solver
+  // can be kept when the model sizes grow
+  DArray<unsigned> _sortEncodingSizes;
+  DArray<unsigned> _distinctSortEncodingSizes;
+
+  // keep the SAT solver between model sizes and only add the constraints new for the current sizes
+  bool _incremental;
+  // if (_incremental) {
+  // the sizes for which the constraints are already in the solver (0 after a reset)
+  DArray<unsigned> _generatedSortSizes;
+  DArray<unsigned> _generatedDistinctSortSizes;
+  bool _groundClausesAdded;
+  // the symmetry axioms depend on the current sizes, so they are guarded by this variable
+  // which is assumed for one round only (0 if none)
+  unsigned _symmetrySelector;
+
+  void nextSymmetrySelector();
+  void recordGeneratedSizes();
+  // }
+
   enum ConstraintSign {
     EQ,     // the value has to matched
     LEQ,    // the value needs to be less or equal
@@ -247,6 +414,9 @@ private:
 
   typedef DArray<pair<ConstraintSign,unsigned>> Constraint_Generator_Vals;
 
+  // the nogood on the (point-wise) domain sizes learned from the failed assumptions
+  void computeNogood(Constraint_Generator_Vals& nogood);
+
   class DSAEnumerator { // Domain Size Assignment Enumerator - for the point-wise encoding case
   public:
     virtual bool init(unsigned, DArray<unsigned>&, Stack<std::pair<unsigned,unsigned>>&, Stack<std::pair<unsigned,unsigned>>&) { return true; }
@@ -179,6 +179,7 @@ typedef Stack<Literal*> LiteralStack;
 typedef VirtualIterator<Literal*> LiteralIterator;
 
 class Inference;
+class InferenceArena;
 
 class Unit;
 typedef List<Unit*> UnitList;
@@ -133,9 +133,15 @@ protected:
   Index() {}
 
   void onAddedToContainer(Clause* c)
-  { handleClause(c, true); }
+  {
+    Allocator::SubsystemScope scope(Allocator::Subsystem::INDICES);
+    handleClause(c, true);
+  }
   void onRemovedFromContainer(Clause* c)
-  { handleClause(c, false); }
+  {
+    Allocator::SubsystemScope scope(Allocator::Subsystem::INDICES);
+    handleClause(c, false);
+  }
 
   virtual void handleClause(Clause* c, bool adding) {}
 
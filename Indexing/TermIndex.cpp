@@ -29,6 +29,8 @@
 #include "Kernel/Term.hpp"
 #include "Kernel/TermIterators.hpp"
 
+#include "Shell/Options.hpp"
+
 #include "TermIndexingStructure.hpp"
 #include "TermIndex.hpp"
 
@@ -147,6 +149,16 @@ void DemodulationSubtermIndex::handleClause(Clause* c, bool adding)
 }
 
 
+DemodulationLHSIndex::~DemodulationLHSIndex()
+{
+  CALL("DemodulationLHSIndex::~DemodulationLHSIndex");
+
+  DHMap<LhsKey,GreaterCheckEntry>::Iterator git(_greaterChecks);
+  while (git.hasNext()) {
+    delete git.next().check;
+  }
+}
+
 void DemodulationLHSIndex::handleClause(Clause* c, bool adding)
 {
   CALL("DemodulationLHSIndex::handleClause");
@@ -158,13 +170,100 @@ void DemodulationLHSIndex::handleClause(Clause* c, bool adding)
   TimeCounter tc(TC_FORWARD_DEMODULATION_INDEX_MAINTENANCE);
 
   Literal* lit=(*c)[0];
+  if (!lit->isEquality()) {
+    return;
+  }
+  Ordering::Result argOrder=_ord.getEqualityArgumentOrder(lit);
+  bool preordered=argOrder==Ordering::LESS || argOrder==Ordering::GREATER;
+  bool groundLookup=_opt.forwardDemodulationGroundLookup() && lit->ground();
   TermIterator lhsi=EqHelper::getDemodulationLHSIterator(lit, true, _ord, _opt);
   while (lhsi.hasNext()) {
+    TermList lhs=lhsi.next();
+    recordChange(lhs, adding);
     if (adding) {
-      _is->insert(lhsi.next(), lit, c);
+      _is->insert(lhs, lit, c);
+      if (!preordered) {
+        addGreaterCheck(lit, lhs);
+      }
+      else if (groundLookup) {
+        GroundRewrite gr;
+        gr.clause=c;
+        gr.literal=lit;
+        gr.rhs=EqHelper::getOtherEqualitySide(lit, lhs);
+        _groundRewrites.insert(lhs.term(), gr);
+      }
     }
     else {
-      _is->remove(lhsi.next(), lit, c);
+      _is->remove(lhs, lit, c);
+      if (!preordered) {
+        removeGreaterCheck(lit, lhs);
+      }
+      else if (groundLookup) {
+        GroundRewrite gr;
+        if (_groundRewrites.find(lhs.term(), gr) && gr.clause==c) {
+          _groundRewrites.remove(lhs.term());
+        }
+      }
     }
   }
 }
+
+void DemodulationLHSIndex::recordChange(TermList lhs, bool adding)
+{
+  if (lhs.isVar() || !lhs.term()->shared()) {
+    (adding ? _varInsertions : _varRemovals)++;
+    return;
+  }
+  unsigned functor=lhs.term()->functor();
+  DArray<unsigned>& counts=adding ? _insertions : _removals;
+  if (functor>=counts.size()) {
+    counts.expand(functor+1, 0);
+  }
+  counts[functor]++;
+}
+
+DemodulationLHSIndex::LhsKey DemodulationLHSIndex::lhsKey(Literal* lit, TermList lhs)
+{
+  return LhsKey(lit, lhs==*lit->nthArgument(0) ? 0 : 1);
+}
+
+void DemodulationLHSIndex::addGreaterCheck(Literal* lit, TermList lhs)
+{
+  CALL("DemodulationLHSIndex::addGreaterCheck");
+
+  GreaterCheckEntry* entry;
+  if (_greaterChecks.getValuePtr(lhsKey(lit, lhs), entry)) {
+    entry->check=_ord.prepareGreaterCheck(lhs, EqHelper::getOtherEqualitySide(lit, lhs));
+    entry->refCnt=0;
+  }
+  entry->refCnt++;
+}
+
+void DemodulationLHSIndex::removeGreaterCheck(Literal* lit, TermList lhs)
+{
+  CALL("DemodulationLHSIndex::removeGreaterCheck");
+
+  LhsKey key=lhsKey(lit, lhs);
+  GreaterCheckEntry* entry;
+  ALWAYS(!_greaterChecks.getValuePtr(key, entry));
+  if (--entry->refCnt==0) {
+    delete entry->check;
+    _greaterChecks.remove(key);
+  }
+}
+
+/**
+ * Return the check of lhs&sigma; &gt; rhs&sigma; for the equation @b lit of
+ * a clause in the index with the left-hand side @b lhs, or 0 if there is
+ * none, such as for equations that are oriented by the ordering.
+ */
+Ordering::GreaterCheck* DemodulationLHSIndex::greaterCheck(Literal* lit, TermList lhs) const
+{
+  CALL("DemodulationLHSIndex::greaterCheck");
+
+  GreaterCheckEntry entry;
+  if (!_greaterChecks.find(lhsKey(lit, lhs), entry)) {
+    return 0;
+  }
+  return entry.check;
+}
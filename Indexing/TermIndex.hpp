@@ -25,6 +25,11 @@
 #ifndef __TermIndex__
 #define __TermIndex__
 
+#include "Lib/DArray.hpp"
+#include "Lib/DHMap.hpp"
+
+#include "Kernel/Ordering.hpp"
+
 #include "Index.hpp"
 
 namespace Indexing {
@@ -111,12 +116,77 @@ public:
   USE_ALLOCATOR(DemodulationLHSIndex);
 
   DemodulationLHSIndex(TermIndexingStructure* is, Ordering& ord, const Options& opt)
-  : TermIndex(is), _ord(ord), _opt(opt) {};
+  : TermIndex(is), _ord(ord), _opt(opt), _varInsertions(0), _varRemovals(0) {};
+  ~DemodulationLHSIndex();
+
+  Ordering::GreaterCheck* greaterCheck(Literal* lit, TermList lhs) const;
+
+  /** Ground unit equation of the index whose larger side is a given term */
+  struct GroundRewrite
+  {
+    Clause* clause;
+    Literal* literal;
+    /** the smaller side */
+    TermList rhs;
+  };
+  /**
+   * If a ground unit equation of the index has @b t as its larger side,
+   * assign it to @b res and return true. Only done if
+   * Options::forwardDemodulationGroundLookup() is set.
+   */
+  bool groundRewrite(Term* t, GroundRewrite& res) const { return _groundRewrites.find(t, res); }
+
+  /**
+   * Number of insertions of left-hand sides that may rewrite a term with
+   * the top functor @b functor at the top. As long as it does not change,
+   * a term irreducible at the top stays so.
+   */
+  unsigned insertionStamp(unsigned functor) const
+  { return _varInsertions + (functor<_insertions.size() ? _insertions[functor] : 0); }
+  /**
+   * Number of insertions and removals of left-hand sides that may rewrite
+   * a term with the top functor @b functor at the top
+   */
+  unsigned changeStamp(unsigned functor) const
+  { return insertionStamp(functor) + _varRemovals + (functor<_removals.size() ? _removals[functor] : 0); }
 protected:
   void handleClause(Clause* c, bool adding);
 private:
+  /** Check of lhs&sigma; &gt; rhs&sigma; shared by the unit clauses with the same literal */
+  struct GreaterCheckEntry
+  {
+    Ordering::GreaterCheck* check;
+    unsigned refCnt;
+  };
+  typedef pair<Literal*,unsigned> LhsKey;
+
+  static LhsKey lhsKey(Literal* lit, TermList lhs);
+  void addGreaterCheck(Literal* lit, TermList lhs);
+  void removeGreaterCheck(Literal* lit, TermList lhs);
+  void recordChange(TermList lhs, bool adding);
+
   Ordering& _ord;
   const Options& _opt;
+  /**
+   * Checks for the equations that are not oriented by the ordering,
+   * indexed by the literal and the argument number of the lhs
+   */
+  DHMap<LhsKey,GreaterCheckEntry> _greaterChecks;
+
+  /**
+   * Ground unit equations by their larger sides. If there are more of them
+   * with the same larger side, only the first one is here.
+   */
+  DHMap<Term*,GroundRewrite> _groundRewrites;
+
+  /** insertions of left-hand sides indexed by their top functor */
+  DArray<unsigned> _insertions;
+  /** removals of left-hand sides indexed by their top functor */
+  DArray<unsigned> _removals;
+  /** insertions of left-hand sides that are variables or special terms */
+  unsigned _varInsertions;
+  /** removals of left-hand sides that are variables or special terms */
+  unsigned _varRemovals;
 };
 
 };
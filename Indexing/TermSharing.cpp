@@ -79,6 +79,7 @@ Term* TermSharing::insert(Term* t)
 {
 
   CALL("TermSharing::insert(Term*)");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::TERMS);
   ASS(!t->isLiteral());
   ASS(!t->isSpecial());
 
@@ -160,6 +161,7 @@ Term* TermSharing::insert(Term* t)
 Literal* TermSharing::insert(Literal* t)
 {
   CALL("TermSharing::insert(Literal*)");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::TERMS);
   ASS(t->isLiteral());
   ASS(!t->isSpecial());
 
@@ -235,6 +237,7 @@ Literal* TermSharing::insert(Literal* t)
 Literal* TermSharing::insertVariableEquality(Literal* t,unsigned sort)
 {
   CALL("TermSharing::insertVariableEquality");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::TERMS);
   ASS(t->isLiteral());
   ASS(t->commutative());
   ASS(t->isEquality());
@@ -106,6 +106,9 @@ struct BackwardDemodulation::ResultFn
     _eqLit=(*_cl)[0];
     _eqSort = SortHelper::getEqualityArgumentSort(_eqLit);
     _removed=SmartPtr<ClauseSet>(new ClauseSet());
+    Ordering::Result argOrder = _ordering.getEqualityArgumentOrder(_eqLit);
+    _preordered = argOrder==Ordering::LESS || argOrder==Ordering::GREATER;
+    _checks=SmartPtr<GreaterChecks>(new GreaterChecks());
   }
   DECL_RETURN_TYPE(BwSimplificationRecord);
   /**
@@ -138,6 +141,18 @@ struct BackwardDemodulation::ResultFn
     TermList lhs=arg.first;
     TermList rhs=EqHelper::getOtherEqualitySide(_eqLit, lhs);
 
+    bool greater=false;
+    if(!_preordered && qr.substitution->isIdentityOnResultWhenQueryBound()) {
+      Ordering::GreaterCheck* check=_checks->get(_ordering, _eqLit, lhs);
+      if(check) {
+        Ordering::GreaterCheck::Outcome outcome=check->check(*qr.substitution, false);
+        if(outcome==Ordering::GreaterCheck::NO) {
+          return BwSimplificationRecord(0);
+        }
+        greater=outcome==Ordering::GreaterCheck::YES;
+      }
+    }
+
     TermList lhsS=qr.term;
     TermList rhsS;
 
@@ -159,7 +174,8 @@ struct BackwardDemodulation::ResultFn
       rhsS=qr.substitution->applyToBoundQuery(rhs);
     }
 
-    if(_ordering.compare(lhsS,rhsS)!=Ordering::GREATER) {
+    //for preordered equations the instances are ordered as well
+    if(!_preordered && !greater && _ordering.compare(lhsS,rhsS)!=Ordering::GREATER) {
       return BwSimplificationRecord(0);
     }
 
@@ -221,10 +237,48 @@ struct BackwardDemodulation::ResultFn
     return BwSimplificationRecord(qr.clause,res);
   }
 private:
+  /**
+   * Checks of lhs&sigma; &gt; rhs&sigma; for the two sides of the equation,
+   * prepared when the side is first used as lhs
+   */
+  struct GreaterChecks
+  {
+    CLASS_NAME(BackwardDemodulation::ResultFn::GreaterChecks);
+    USE_ALLOCATOR(GreaterChecks);
+
+    GreaterChecks()
+    {
+      for(unsigned i=0;i<2;i++) {
+        prepared[i]=false;
+        checks[i]=0;
+      }
+    }
+    ~GreaterChecks()
+    {
+      for(unsigned i=0;i<2;i++) {
+        delete checks[i];
+      }
+    }
+    Ordering::GreaterCheck* get(Ordering& ord, Literal* eqLit, TermList lhs)
+    {
+      unsigned i = lhs==*eqLit->nthArgument(0) ? 0 : 1;
+      if(!prepared[i]) {
+        checks[i]=ord.prepareGreaterCheck(lhs, EqHelper::getOtherEqualitySide(eqLit, lhs));
+        prepared[i]=true;
+      }
+      return checks[i];
+    }
+
+    bool prepared[2];
+    Ordering::GreaterCheck* checks[2];
+  };
+
   unsigned _eqSort;
   Literal* _eqLit;
   Clause* _cl;
   SmartPtr<ClauseSet> _removed;
+  bool _preordered;
+  SmartPtr<GreaterChecks> _checks;
 
   BackwardDemodulation& _parent;
   Ordering& _ordering;
@@ -67,12 +67,14 @@ void ForwardDemodulation::attach(SaturationAlgorithm* salg)
 	  _salg->getIndexManager()->request(DEMODULATION_LHS_SUBST_TREE) );
 
   _preorderedOnly=getOptions().forwardDemodulation()==Options::Demodulation::PREORDERED;
+  _groundLookup=getOptions().forwardDemodulationGroundLookup();
 }
 
 void ForwardDemodulation::detach()
 {
   CALL("ForwardDemodulation::detach");
   _index=0;
+  _rewriteCache.reset();
   _salg->getIndexManager()->release(DEMODULATION_LHS_SUBST_TREE);
   ForwardSimplificationEngine::detach();
 }
@@ -113,12 +115,37 @@ bool ForwardDemodulation::perform(Clause* cl, Clause*& replacement, ClauseIterat
       bool toplevelCheck=getOptions().demodulationRedundancyCheck() && lit->isEquality() &&
 	  (trm==*lit->nthArgument(0) || trm==*lit->nthArgument(1));
 
+      if(_groundLookup && trm.term()->ground()) {
+	//ground unit equalities are oriented, so one with trm as its larger side rewrites it
+	DemodulationLHSIndex::GroundRewrite gr;
+	if(_index->groundRewrite(trm.term(), gr) && ColorHelper::compatible(cl->color(), gr.clause->color()) &&
+	    !(toplevelCheck && redundancyCheckFails(cl, li, trm, gr.rhs, gr.literal, 0))) {
+	  return rewrite(cl, lit, trm, gr.rhs, gr.clause, replacement, premises);
+	}
+      }
+
+      //the outcome of the retrieval can be cached only if it did not depend
+      //on the clause, which is the colour and the redundancy check
+      bool cacheable=!toplevelCheck && trm.term()->shared();
+      if(cacheable) {
+	RewriteCacheEntry* entry=_rewriteCache.findPtr(trm.term());
+	if(entry && entry->stamp==currentStamp(trm.term(), entry->premise)) {
+	  if(!entry->premise) {
+	    continue;
+	  }
+	  if(ColorHelper::compatible(cl->color(), entry->premise->color())) {
+	    return rewrite(cl, lit, trm, entry->rhs, entry->premise, replacement, premises);
+	  }
+	}
+      }
+
       TermQueryResultIterator git=_index->getGeneralizations(trm, true);
       while(git.hasNext()) {
 	TermQueryResult qr=git.next();
 	ASS_EQ(qr.clause->length(),1);
 
 	if(!ColorHelper::compatible(cl->color(), qr.clause->color())) {
+	  cacheable=false;
 	  continue;
 	}
 
@@ -128,6 +155,25 @@ bool ForwardDemodulation::perform(Clause* cl, Clause*& replacement, ClauseIterat
 	  continue;
 	}
 
+	Ordering::Result argOrder = ordering.getEqualityArgumentOrder(qr.literal);
+	bool preordered = argOrder==Ordering::LESS || argOrder==Ordering::GREATER;
+	if(!preordered && _preorderedOnly) {
+	  continue;
+	}
+	bool greater = preordered;
+	if(!preordered && qr.substitution->isIdentityOnQueryWhenResultBound()) {
+	  //the precompiled check mostly decides the comparison without
+	  //building the instance of rhs
+	  Ordering::GreaterCheck* check = _index->greaterCheck(qr.literal, qr.term);
+	  if(check) {
+	    Ordering::GreaterCheck::Outcome outcome = check->check(*qr.substitution, true);
+	    if(outcome==Ordering::GreaterCheck::NO) {
+	      continue;
+	    }
+	    greater = outcome==Ordering::GreaterCheck::YES;
+	  }
+	}
+
 	TermList rhs=EqHelper::getOtherEqualitySide(qr.literal,qr.term);
 	TermList rhsS;
 	if(!qr.substitution->isIdentityOnQueryWhenResultBound()) {
@@ -146,8 +192,6 @@ bool ForwardDemodulation::perform(Clause* cl, Clause*& replacement, ClauseIterat
 	  rhsS=qr.substitution->applyToBoundResult(rhs);
 	}
 
-	Ordering::Result argOrder = ordering.getEqualityArgumentOrder(qr.literal);
-	bool preordered = argOrder==Ordering::LESS || argOrder==Ordering::GREATER;
 #if VDEBUG
 	if(preordered) {
 	  if(argOrder==Ordering::LESS) {
@@ -157,70 +201,136 @@ bool ForwardDemodulation::perform(Clause* cl, Clause*& replacement, ClauseIterat
 	    ASS_EQ(rhs, *qr.literal->nthArgument(1));
 	  }
 	}
+	if(greater && !preordered) {
+	  ASS_EQ(ordering.compare(trm,rhsS), Ordering::GREATER);
+	}
 #endif
-	if(!preordered && (_preorderedOnly || ordering.compare(trm,rhsS)!=Ordering::GREATER) ) {
+	if(!greater && ordering.compare(trm,rhsS)!=Ordering::GREATER) {
 	  continue;
 	}
 
-	if(toplevelCheck) {
-	  TermList other=EqHelper::getOtherEqualitySide(lit, trm);
-	  Ordering::Result tord=ordering.compare(rhsS, other);
-	  if(tord!=Ordering::LESS && tord!=Ordering::LESS_EQ) {
-	    Literal* eqLitS=qr.substitution->applyToBoundResult(qr.literal);
-	    bool isMax=true;
-	    for(unsigned li2=0;li2<cLen;li2++) {
-	      if(li==li2) {
-		continue;
-	      }
-	      if(ordering.compare(eqLitS, (*cl)[li2])==Ordering::LESS) {
-		isMax=false;
-		break;
-	      }
-	    }
-	    if(isMax) {
-	      //RSTAT_CTR_INC("tlCheck prevented");
-	      //The demodulation is this case which doesn't preserve completeness:
-	      //s = t     s = t1 \/ C
-	      //---------------------
-	      //     t = t1 \/ C
-	      //where t > t1 and s = t > C
-	      continue;
-	    }
-	  }
+	if(toplevelCheck && redundancyCheckFails(cl, li, trm, rhsS, qr.literal, qr.substitution.ptr())) {
+	  continue;
 	}
 
-	Literal* resLit = EqHelper::replace(lit,trm,rhsS);
-	if(EqHelper::isEqTautology(resLit)) {
-	  env.statistics->forwardDemodulationsToEqTaut++;
-	  premises = pvi( getSingletonIterator(qr.clause));
-	  return true;
+	if(cacheable) {
+	  cacheRewrite(trm.term(), rhsS, qr.clause);
 	}
+	return rewrite(cl, lit, trm, rhsS, qr.clause, replacement, premises);
+      }
+      if(cacheable) {
+	cacheRewrite(trm.term(), TermList(), 0);
+      }
+    }
+  }
 
-	Clause* res = new(cLen) Clause(cLen,
-	  SimplifyingInference2(InferenceRule::FORWARD_DEMODULATION, cl, qr.clause));
+  return false;
+}
 
-	(*res)[0]=resLit;
+/**
+ * Return true if rewriting @b trm, an argument of the equality @b li of @b cl,
+ * to @b rhsS by the unit equation @b eqLit instantiated by @b subst (or as it
+ * is if @b subst is 0) is the following case, which does not preserve
+ * completeness:
+ *
+ * s = t     s = t1 \/ C
+ * ---------------------
+ *      t = t1 \/ C
+ *
+ * where t > t1 and s = t > C
+ */
+bool ForwardDemodulation::redundancyCheckFails(Clause* cl, unsigned li, TermList trm, TermList rhsS,
+    Literal* eqLit, ResultSubstitution* subst)
+{
+  CALL("ForwardDemodulation::redundancyCheckFails");
 
-	unsigned next=1;
-	for(unsigned i=0;i<cLen;i++) {
-	  Literal* curr=(*cl)[i];
-	  if(curr!=lit) {
-	    (*res)[next++] = curr;
-	  }
-	}
-	ASS_EQ(next,cLen);
+  Ordering& ordering = _salg->getOrdering();
+  Literal* lit=(*cl)[li];
+  TermList other=EqHelper::getOtherEqualitySide(lit, trm);
+  Ordering::Result tord=ordering.compare(rhsS, other);
+  if(tord==Ordering::LESS || tord==Ordering::LESS_EQ) {
+    return false;
+  }
+  Literal* eqLitS=subst ? subst->applyToBoundResult(eqLit) : eqLit;
+  unsigned cLen=cl->length();
+  for(unsigned li2=0;li2<cLen;li2++) {
+    if(li==li2) {
+      continue;
+    }
+    if(ordering.compare(eqLitS, (*cl)[li2])==Ordering::LESS) {
+      return false;
+    }
+  }
+  //RSTAT_CTR_INC("tlCheck prevented");
+  return true;
+}
 
-	env.statistics->forwardDemodulations++;
+/**
+ * Return the stamp of the index at which a cache entry of @b t with the
+ * premise @b premise is valid
+ */
+unsigned ForwardDemodulation::currentStamp(Term* t, Clause* premise) const
+{
+  // the rewrite by a premise may change when the premise is removed or
+  // a demodulator retrieved before it inserted, but a term with no rewrite
+  // only gets one by an insertion
+  return premise ? _index->changeStamp(t->functor()) : _index->insertionStamp(t->functor());
+}
 
-	premises = pvi( getSingletonIterator(qr.clause));
-	replacement = res;
-	return true;
+/**
+ * Record that the first demodulator rewriting @b t at the top in any clause
+ * is @b premise giving @b rhs, or that there is none if @b premise is 0
+ */
+void ForwardDemodulation::cacheRewrite(Term* t, TermList rhs, Clause* premise)
+{
+  CALL("ForwardDemodulation::cacheRewrite");
 
-      }
+  if(_rewriteCache.size()>=REWRITE_CACHE_LIMIT) {
+    _rewriteCache.reset();
+  }
+  RewriteCacheEntry entry;
+  entry.stamp=currentStamp(t, premise);
+  entry.premise=premise;
+  entry.rhs=rhs;
+  _rewriteCache.set(t, entry);
+}
+
+/**
+ * Rewrite @b trm in the literal @b lit of @b cl to @b rhsS
+ * by the unit equation @b premise
+ */
+bool ForwardDemodulation::rewrite(Clause* cl, Literal* lit, TermList trm, TermList rhsS, Clause* premise,
+    Clause*& replacement, ClauseIterator& premises)
+{
+  CALL("ForwardDemodulation::rewrite");
+
+  unsigned cLen=cl->length();
+  Literal* resLit = EqHelper::replace(lit,trm,rhsS);
+  if(EqHelper::isEqTautology(resLit)) {
+    env.statistics->forwardDemodulationsToEqTaut++;
+    premises = pvi( getSingletonIterator(premise));
+    return true;
+  }
+
+  Clause* res = new(cLen) Clause(cLen,
+    SimplifyingInference2(InferenceRule::FORWARD_DEMODULATION, cl, premise));
+
+  (*res)[0]=resLit;
+
+  unsigned next=1;
+  for(unsigned i=0;i<cLen;i++) {
+    Literal* curr=(*cl)[i];
+    if(curr!=lit) {
+      (*res)[next++] = curr;
     }
   }
+  ASS_EQ(next,cLen);
 
-  return false;
+  env.statistics->forwardDemodulations++;
+
+  premises = pvi( getSingletonIterator(premise));
+  replacement = res;
+  return true;
 }
 
 }
@@ -26,6 +26,7 @@
 #define __ForwardDemodulation__
 
 #include "Forwards.hpp"
+#include "Lib/DHMap.hpp"
 #include "Indexing/TermIndex.hpp"
 
 #include "InferenceEngine.hpp"
@@ -48,8 +49,35 @@ public:
   void detach() override;
   bool perform(Clause* cl, Clause*& replacement, ClauseIterator& premises) override;
 private:
+  /**
+   * The first demodulator that rewrites a term at the top in clauses of any
+   * colour, where the term is not an argument of an equality so that the
+   * redundancy check does not apply
+   */
+  struct RewriteCacheEntry
+  {
+    /** the stamp of the index when the entry was made, see currentStamp() */
+    unsigned stamp;
+    /** the unit equation, or 0 if no demodulator rewrites the term */
+    Clause* premise;
+    /** the instance of the other side of the equation */
+    TermList rhs;
+  };
+  /** number of entries at which the cache is emptied */
+  static const unsigned REWRITE_CACHE_LIMIT = 1u<<18;
+
+  bool redundancyCheckFails(Clause* cl, unsigned li, TermList trm, TermList rhsS,
+      Literal* eqLit, ResultSubstitution* subst);
+  unsigned currentStamp(Term* t, Clause* premise) const;
+  void cacheRewrite(Term* t, TermList rhs, Clause* premise);
+  bool rewrite(Clause* cl, Literal* lit, TermList trm, TermList rhsS, Clause* premise,
+      Clause*& replacement, ClauseIterator& premises);
+
   bool _preorderedOnly;
+  bool _groundLookup;
   DemodulationLHSIndex* _index;
+  /** rewrites of shared terms at the top, so that a term is looked up in the index once */
+  DHMap<Term*,RewriteCacheEntry> _rewriteCache;
 };
 
 };
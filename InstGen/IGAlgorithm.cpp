@@ -129,6 +129,16 @@ IGAlgorithm::IGAlgorithm(Problem& prb,const Options& opt)
   }
   _selected = new LiteralSubstitutionTree();
 
+  _incrementalRestart = _opt.instGenIncrementalRestart();
+  _groundedIdx = 0;
+  if (_incrementalRestart) {
+    if (_use_hashing) {
+      _groundedIdx = new HashingClauseVariantIndex();
+    } else {
+      _groundedIdx = new SubstitutionTreeClauseVariantIndex();
+    }
+  }
+
   _doingSatisfiabilityCheck = false;
 }
 
@@ -138,6 +148,9 @@ IGAlgorithm::~IGAlgorithm()
 
   delete _selected;
   delete _variantIdx;
+  if (_groundedIdx) {
+    delete _groundedIdx;
+  }
   delete _satSolver;
   if (_equalityProxy) {
     delete _equalityProxy;
@@ -301,6 +314,16 @@ void IGAlgorithm::processUnprocessed()
       env.endOutput();
     }
 
+    if (_groundedIdx) {
+      TimeCounter tc2(TC_INST_GEN_VARIANT_DETECTION);
+      // all variants have the same grounding, which the solver already has
+      if (_groundedIdx->retrieveVariants(cl).hasNext()) {
+        continue;
+      }
+      cl->incRefCnt();
+      _groundedIdx->insert(cl);
+    }
+
     SATClause* sc = _gnd->ground(cl,_use_niceness);
     sc = Preprocess::removeDuplicateLiterals(sc); //this is required by the SAT solver
 
@@ -747,6 +770,40 @@ void IGAlgorithm::doPassiveReactivation()
   _deactivatedSet.reset();
 }
 
+/**
+ * Send the active clauses with a selected literal that is no longer true
+ * in the current model back to passive (and out of the index). The other
+ * active clauses have already been used with all the clauses in the index,
+ * so they do not need to be activated again.
+ */
+void IGAlgorithm::reactivateChangedSelection()
+{
+  CALL("IGAlgorithm::reactivateChangedSelection");
+
+  RCClauseStack::DelIterator ait(_active);
+  while(ait.hasNext()) {
+    Clause* cl = ait.next();
+    unsigned selCnt = cl->numSelected();
+    bool changed = false;
+    for(unsigned i=0; i<selCnt; i++) {
+      if(!isSelected((*cl)[i])) {
+        changed = true;
+        break;
+      }
+    }
+    if(!changed) {
+      continue;
+    }
+    removeFromIndex(cl);
+    _passive.add(cl);
+    cl->incRefCnt(); //corresponds to addition to passive
+    ait.del();
+  }
+
+  _deactivated.reset();
+  _deactivatedSet.reset();
+}
+
 void IGAlgorithm::wipeIndexes()
 {
   CALL("IGAlgorithm::wipeIndexes");
@@ -769,6 +826,11 @@ void IGAlgorithm::restartWithCurrentClauses()
 {
   CALL("IGAlgorithm::restartWithCurrentClauses");
 
+  if(_incrementalRestart) {
+    reactivateChangedSelection();
+    return;
+  }
+
   static RCClauseStack allClauses;
   allClauses.reset();
 
@@ -900,6 +962,10 @@ MainLoopResult IGAlgorithm::runImpl()
       restartWithCurrentClauses();
       _doingSatisfiabilityCheck = true;
       processUnprocessed();
+      if(_incrementalRestart) {
+        // the model may have changed when solving
+        reactivateChangedSelection();
+      }
       while(!_passive.isEmpty() && _unprocessed.isEmpty()) {
         Clause* given = _passive.popSelected();
         activate(given);
@@ -100,6 +100,7 @@ private:
   void deactivate(Clause* cl);
   void doImmediateReactivation();
   void doPassiveReactivation();
+  void reactivateChangedSelection();
 
   unsigned lookaheadSelection(Clause* cl, unsigned selCnt);
 
@@ -169,6 +170,14 @@ private:
   bool _use_hashing;
   ClauseVariantIndex* _variantIdx;
 
+  /**
+   * If true, small restarts keep the indexes and _groundedIdx is used
+   * to avoid adding the same ground clauses to the SAT solver repeatedly
+   */
+  bool _incrementalRestart;
+  /** Clauses already grounded into the SAT solver (survives restarts) */
+  ClauseVariantIndex* _groundedIdx;
+
   LiteralSubstitutionTree* _selected;
 
   DuplicateLiteralRemovalISE _duplicateLiteralRemoval;
@@ -43,6 +43,7 @@
 #include "Shell/Options.hpp"
 
 #include "Inference.hpp"
+#include "InferenceStore.hpp"
 #include "Signature.hpp"
 #include "Term.hpp"
 #include "TermIterators.hpp"
@@ -65,23 +66,28 @@ bool Clause::_auxInUse = false;
 #endif
 
 
-/** New clause */
-Clause::Clause(unsigned length,const Inference& inf)
-  : Unit(Unit::CLAUSE,inf),
+/** New clause, with a new number unless @b number is non-zero */
+Clause::Clause(unsigned length,const Inference& inf,unsigned number)
+  : Unit(Unit::CLAUSE,inf,number),
     _length(length),
     _color(COLOR_INVALID),
     _extensionality(false),
     _extensionalityTag(false),
     _component(false),
+    _inferenceArchived(false),
     _store(NONE),
     _numSelected(0),
     _weight(0),
     _weightForClauseSelection(0),
-    _refCnt(0),
+    // clauses from preprocessing are pointed to from many places that do not
+    // count, so they start with a reference only the Problem gives up
+    _refCnt(isFromPreprocessing() ? 1 : 0),
     _reductionTimestamp(0),
     _literalPositions(0),
     _numActiveSplits(0),
-    _auxTimestamp(0)
+    _auxTimestamp(0),
+    _bucketPrev(0),
+    _bucketNext(0)
 {
   // MS: TODO: not sure if this belongs here and whether EXTENSIONALITY_AXIOM input types ever appear anywhere (as a vampire-extension TPTP formula role)
   if(inference().inputType() == UnitInputType::EXTENSIONALITY_AXIOM){
@@ -108,6 +114,7 @@ void* Clause::operator new(size_t sz, unsigned lits)
   size_t size = sizeof(Clause) + lits * sizeof(Literal*);
   size -= sizeof(Literal*);
 
+  Allocator::SubsystemScope scope(Allocator::Subsystem::CLAUSES);
   return ALLOC_KNOWN(size,"Clause");
 }
 
@@ -123,11 +130,14 @@ void Clause::operator delete(void* ptr,unsigned length)
   size_t size = sizeof(Clause) + length * sizeof(Literal*);
   size -= sizeof(Literal*);
 
+  Allocator::SubsystemScope scope(Allocator::Subsystem::CLAUSES);
   DEALLOC_KNOWN(ptr, size,"Clause");
 }
 
 void Clause::destroyExceptInferenceObject()
 {
+  Allocator::SubsystemScope scope(Allocator::Subsystem::CLAUSES);
+
   if (_literalPositions) {
     delete _literalPositions;
   }
@@ -179,10 +189,28 @@ Clause* Clause::fromClause(Clause* c)
   return res;
 }
 
+/**
+ * Create a clause with number @b number, literals @b lits and inference @b inf
+ * of a clause that was kept in a compact form after its original object was
+ * destroyed by destroyExceptInferenceObject(). The new clause takes over
+ * the inference, including the references to premises.
+ */
+Clause* Clause::restore(unsigned number, unsigned length, Literal* const* lits, const Inference& inf)
+{
+  CALL("Clause::restore");
+
+  Clause* res = new (length) Clause(length, inf, number);
+  for(unsigned i = 0; i < length; i++) {
+    (*res)[i] = lits[i];
+  }
+  // a clause from preprocessing is only compacted once the problem gave up its reference
+  res->_refCnt = 0;
+  return res;
+}
+
 bool Clause::shouldBeDestroyed()
 {
-  return (_store == NONE) && _refCnt == 0 &&
-    !isFromPreprocessing();
+  return (_store == NONE) && _refCnt == 0;
 }
 
 /**
@@ -220,6 +248,10 @@ void Clause::destroy()
         toDestroy.push(refCl);
       }
     }
+    if (cl->isFromPreprocessing()) {
+      // the address may be reused, so what is recorded about it must go
+      InferenceStore::instance()->onUnitDeleted(cl);
+    }
     cl->_inference.destroyDirectlyOwned();
     cl->destroyExceptInferenceObject();
     if (toDestroy.isEmpty()) {
@@ -82,7 +82,7 @@ public:
     SELECTED = 4u
   };
 
-  Clause(unsigned length,const Inference& inf);
+  Clause(unsigned length,const Inference& inf,unsigned number = 0);
 
   void* operator new(size_t,unsigned length);
   void operator delete(void* ptr,unsigned length);
@@ -101,6 +101,7 @@ public:
   }
 
   static Clause* fromClause(Clause* c);
+  static Clause* restore(unsigned number, unsigned length, Literal* const* lits, const Inference& inf);
 
   /**
    * Return the (reference to) the nth literal
@@ -203,6 +204,10 @@ public:
 
   bool isComponent() const { return _component; }
   void setComponent(bool c) { _component = c; }
+
+  /** True if the inference of the clause was moved to an InferenceArena */
+  bool inferenceArchived() const { return _inferenceArchived; }
+  void markInferenceArchived() { _inferenceArchived = true; }
   
   bool skip() const;
 
@@ -212,6 +217,7 @@ public:
   bool shouldBeDestroyed();
   void destroyIfUnnecessary();
 
+  unsigned refCnt() const { return _refCnt; }
   void incRefCnt() { _refCnt++; }
   void decRefCnt()
   {
@@ -362,6 +368,8 @@ protected:
   unsigned _extensionalityTag : 1;
   /** Clause is a splitting component. */
   unsigned _component : 1;
+  /** The premises of the clause are recorded in an InferenceArena */
+  unsigned _inferenceArchived : 1;
 
   /** storage class */
   Store _store : 3;
@@ -386,6 +394,11 @@ protected:
   size_t _auxTimestamp;
   void* _auxData;
 
+  /** links within a bucket of ClauseBucketQueue, 0 if the clause is in none */
+  Clause* _bucketPrev;
+  Clause* _bucketNext;
+  friend class ClauseBucketQueue;
+
   static size_t _auxCurrTimestamp;
 #if VDEBUG
   static bool _auxInUse;
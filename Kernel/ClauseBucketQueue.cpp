@@ -0,0 +1,323 @@
+
+/*
+ * File ClauseBucketQueue.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file ClauseBucketQueue.cpp
+ * Implements class ClauseBucketQueue.
+ */
+
+#include "Debug/Tracer.hpp"
+
+#include "Shell/Options.hpp"
+
+#include "ClauseBucketQueue.hpp"
+
+namespace Kernel
+{
+
+ClauseBucketQueue::ClauseBucketQueue(const Shell::Options& opt)
+: _opt(opt), _minWeight(0), _minAge(0), _size(0)
+{
+}
+
+ClauseBucketQueue::~ClauseBucketQueue()
+{
+  CALL("ClauseBucketQueue::~ClauseBucketQueue");
+
+  DHMap<std::pair<unsigned,unsigned>,Bucket*>::Iterator bit(_buckets);
+  while(bit.hasNext()) {
+    Bucket* b = bit.next();
+    Clause* cl = b->first;
+    do {
+      Clause* next = cl->_bucketNext;
+      cl->_bucketPrev = 0;
+      cl->_bucketNext = 0;
+      cl = next;
+    } while(cl!=b->first);
+    delete b;
+  }
+}
+
+/**
+ * True if @b c1 goes before @b c2 within a bucket, i.e. if it has
+ * a greater input type, or the same input type and a smaller number
+ */
+bool ClauseBucketQueue::precedes(Clause* c1, Clause* c2)
+{
+  if(c1->inputType()!=c2->inputType()) {
+    return c1->inputType() > c2->inputType();
+  }
+  return c1->number() < c2->number();
+}
+
+void ClauseBucketQueue::insert(Clause* cl)
+{
+  CALL("ClauseBucketQueue::insert");
+  ASS(!cl->_bucketNext);
+
+  unsigned w = cl->weightForClauseSelection(_opt);
+  unsigned a = cl->age();
+
+  Bucket** pbucket;
+  if(_buckets.getValuePtr(std::make_pair(w,a), pbucket, nullptr)) {
+    *pbucket = new Bucket(w, a);
+  }
+  Bucket* bucket = *pbucket;
+
+  Clause*& first = bucket->first;
+  if(!first) {
+    first = cl;
+    cl->_bucketPrev = cl;
+    cl->_bucketNext = cl;
+    linkBucket(bucket);
+  }
+  else {
+    // clauses mostly come in the order of their numbers, so we search from the back
+    Clause* prev = first->_bucketPrev;
+    bool isFirst = false;
+    while(precedes(cl, prev)) {
+      if(prev==first) {
+        isFirst = true;
+        break;
+      }
+      prev = prev->_bucketPrev;
+    }
+    if(isFirst) {
+      prev = first->_bucketPrev;
+      first = cl;
+    }
+    cl->_bucketPrev = prev;
+    cl->_bucketNext = prev->_bucketNext;
+    prev->_bucketNext->_bucketPrev = cl;
+    prev->_bucketNext = cl;
+  }
+  _size++;
+} // ClauseBucketQueue::insert
+
+/**
+ * Remove @b cl from the queue and return true, or return false
+ * if the clause is not in the queue
+ */
+bool ClauseBucketQueue::remove(Clause* cl)
+{
+  CALL("ClauseBucketQueue::remove");
+
+  if(!cl->_bucketNext) {
+    return false;
+  }
+  // in a bucket, only the first clause precedes the one before it (the last one)
+  if(cl->_bucketNext!=cl && !precedes(cl, cl->_bucketPrev)) {
+    cl->_bucketPrev->_bucketNext = cl->_bucketNext;
+    cl->_bucketNext->_bucketPrev = cl->_bucketPrev;
+    cl->_bucketPrev = 0;
+    cl->_bucketNext = 0;
+    _size--;
+  }
+  else {
+    // only here the bucket needs to be updated
+    popFirst(_buckets.get(std::make_pair(cl->weightForClauseSelection(_opt), cl->age())));
+  }
+  return true;
+} // ClauseBucketQueue::remove
+
+/**
+ * Remove the first clause of bucket @b b from the queue and return it.
+ * If the bucket becomes empty, it is deleted.
+ */
+Clause* ClauseBucketQueue::popFirst(Bucket* b)
+{
+  CALL("ClauseBucketQueue::popFirst");
+
+  Clause* cl = b->first;
+  if(cl->_bucketNext==cl) {
+    unlinkBucket(b);
+    ALWAYS(_buckets.remove(std::make_pair(b->weight, b->age)));
+    delete b;
+  }
+  else {
+    cl->_bucketPrev->_bucketNext = cl->_bucketNext;
+    cl->_bucketNext->_bucketPrev = cl->_bucketPrev;
+    b->first = cl->_bucketNext;
+  }
+  cl->_bucketPrev = 0;
+  cl->_bucketNext = 0;
+  _size--;
+  return cl;
+}
+
+namespace {
+
+/**
+ * Insert bucket @b b into the circular list starting at @b first,
+ * linked through @b prev and @b next and sorted by @b key
+ */
+template<class Bucket>
+void linkSorted(Bucket*& first, Bucket* b, unsigned Bucket::*key, Bucket* Bucket::*prev, Bucket* Bucket::*next)
+{
+  if(!first) {
+    first = b;
+    b->*prev = b;
+    b->*next = b;
+    return;
+  }
+  // new buckets are mostly the last ones, so we search from the back
+  Bucket* p = first->*prev;
+  bool isFirst = false;
+  while(b->*key < p->*key) {
+    if(p==first) {
+      isFirst = true;
+      break;
+    }
+    p = p->*prev;
+  }
+  if(isFirst) {
+    p = first->*prev;
+    first = b;
+  }
+  b->*prev = p;
+  b->*next = p->*next;
+  (p->*next)->*prev = b;
+  p->*next = b;
+}
+
+/**
+ * Remove bucket @b b from the circular list starting at @b first,
+ * linked through @b prev and @b next
+ */
+template<class Bucket>
+void unlinkFrom(Bucket*& first, Bucket* b, Bucket* Bucket::*prev, Bucket* Bucket::*next)
+{
+  if(b->*next==b) {
+    first = 0;
+    return;
+  }
+  (b->*prev)->*next = b->*next;
+  (b->*next)->*prev = b->*prev;
+  if(first==b) {
+    first = b->*next;
+  }
+}
+
+}
+
+/**
+ * Add the new bucket @b b to the lists of its weight and of its age
+ */
+void ClauseBucketQueue::linkBucket(Bucket* b)
+{
+  CALL("ClauseBucketQueue::linkBucket");
+
+  while(_rows.size()<=b->weight) {
+    _rows.push(0);
+  }
+  while(_cols.size()<=b->age) {
+    _cols.push(0);
+  }
+  linkSorted(_rows[b->weight], b, &Bucket::age, &Bucket::prevInRow, &Bucket::nextInRow);
+  linkSorted(_cols[b->age], b, &Bucket::weight, &Bucket::prevInCol, &Bucket::nextInCol);
+  _minWeight = min(_minWeight, b->weight);
+  _minAge = min(_minAge, b->age);
+}
+
+/**
+ * Remove the emptied bucket @b b from the lists of its weight and of its age
+ */
+void ClauseBucketQueue::unlinkBucket(Bucket* b)
+{
+  CALL("ClauseBucketQueue::unlinkBucket");
+
+  unlinkFrom(_rows[b->weight], b, &Bucket::prevInRow, &Bucket::nextInRow);
+  unlinkFrom(_cols[b->age], b, &Bucket::prevInCol, &Bucket::nextInCol);
+}
+
+/**
+ * Remove from the queue and return the first clause in the weight order
+ */
+Clause* ClauseBucketQueue::popByWeight()
+{
+  CALL("ClauseBucketQueue::popByWeight");
+  ASS(!isEmpty());
+
+  while(!_rows[_minWeight]) {
+    _minWeight++;
+  }
+  return popFirst(_rows[_minWeight]);
+}
+
+/**
+ * Remove from the queue and return the first clause in the age order
+ */
+Clause* ClauseBucketQueue::popByAge()
+{
+  CALL("ClauseBucketQueue::popByAge");
+  ASS(!isEmpty());
+
+  while(!_cols[_minAge]) {
+    _minAge++;
+  }
+  return popFirst(_cols[_minAge]);
+}
+
+ClauseBucketQueue::Iterator::Iterator(const ClauseBucketQueue& queue, bool byWeight)
+: _lines(byWeight ? queue._rows : queue._cols), _byWeight(byWeight),
+  _idx(byWeight ? queue._minWeight : queue._minAge), _bucket(0), _next(0)
+{
+  CALL("ClauseBucketQueue::Iterator::Iterator");
+
+  nextLine();
+}
+
+/**
+ * Move to the first clause of the first non-empty row or column
+ * starting from _idx
+ */
+void ClauseBucketQueue::Iterator::nextLine()
+{
+  while(_idx<_lines.size() && !_lines[_idx]) {
+    _idx++;
+  }
+  if(_idx<_lines.size()) {
+    _bucket = _lines[_idx];
+    _next = _bucket->first;
+  }
+  else {
+    _next = 0;
+  }
+}
+
+Clause* ClauseBucketQueue::Iterator::next()
+{
+  CALL("ClauseBucketQueue::Iterator::next");
+  ASS(_next);
+
+  Clause* res = _next;
+  _next = _next->_bucketNext;
+  if(_next==_bucket->first) {
+    _bucket = _byWeight ? _bucket->nextInRow : _bucket->nextInCol;
+    if(_bucket==_lines[_idx]) {
+      _idx++;
+      nextLine();
+    }
+    else {
+      _next = _bucket->first;
+    }
+  }
+  return res;
+}
+
+}
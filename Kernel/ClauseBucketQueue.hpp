@@ -0,0 +1,144 @@
+
+/*
+ * File ClauseBucketQueue.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file ClauseBucketQueue.hpp
+ * Defines class ClauseBucketQueue.
+ */
+
+#ifndef __ClauseBucketQueue__
+#define __ClauseBucketQueue__
+
+#include "Forwards.hpp"
+
+#include "Lib/Allocator.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Reflection.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Clause.hpp"
+
+namespace Kernel {
+
+using namespace Lib;
+
+/**
+ * A queue of passive clauses that can be popped both in the weight and
+ * in the age order, organised in buckets of clauses of the same clause
+ * selection weight and age.
+ *
+ * The two orders are the same as the ones of WeightQueue and AgeQueue:
+ * weight, age, input type (greater first) and number, respectively
+ * age, weight, input type and number. Each bucket is a circular list
+ * sorted by input type and number, linked through fields of Clause, so
+ * a clause can be in one such queue at a time.
+ *
+ * Non-empty buckets of each weight form a circular list sorted by age,
+ * and those of each age one sorted by weight. The first lists are indexed
+ * by weight and the second by age, and popping scans them upwards from
+ * the lowest index that may be non-empty, as in a bucket queue.
+ *
+ * A new clause finds its bucket in a hash map, which is also used to
+ * remove the first clause of a bucket other than by popping. Otherwise
+ * inserting, removing and popping take constant time, except for finding
+ * the place of a new bucket in its lists and of a clause in its bucket;
+ * both are searched from the back, where the new ones usually go.
+ */
+class ClauseBucketQueue
+{
+public:
+  CLASS_NAME(ClauseBucketQueue);
+  USE_ALLOCATOR(ClauseBucketQueue);
+
+  ClauseBucketQueue(const Shell::Options& opt);
+  ~ClauseBucketQueue();
+
+  void insert(Clause* cl);
+  bool remove(Clause* cl);
+  Clause* popByWeight();
+  Clause* popByAge();
+
+  /** True if the queue is empty */
+  bool isEmpty() const { return _size==0; }
+
+private:
+  /** Clauses of one weight and age */
+  struct Bucket
+  {
+    CLASS_NAME(ClauseBucketQueue::Bucket);
+    USE_ALLOCATOR(ClauseBucketQueue::Bucket);
+
+    Bucket(unsigned weight, unsigned age) : weight(weight), age(age), first(0) {}
+
+    unsigned weight;
+    unsigned age;
+    /** first clause of the circular list */
+    Clause* first;
+    /** neighbours among the buckets of the same weight */
+    Bucket* prevInRow;
+    Bucket* nextInRow;
+    /** neighbours among the buckets of the same age */
+    Bucket* prevInCol;
+    Bucket* nextInCol;
+  };
+
+  static bool precedes(Clause* c1, Clause* c2);
+  void linkBucket(Bucket* b);
+  void unlinkBucket(Bucket* b);
+  Clause* popFirst(Bucket* b);
+
+  const Shell::Options& _opt;
+  /** non-empty buckets by weight and age */
+  DHMap<std::pair<unsigned,unsigned>,Bucket*> _buckets;
+  /** first bucket of each weight, 0 if there is none */
+  Stack<Bucket*> _rows;
+  /** first bucket of each age, 0 if there is none */
+  Stack<Bucket*> _cols;
+  /** all rows below are empty */
+  unsigned _minWeight;
+  /** all columns below are empty */
+  unsigned _minAge;
+  unsigned _size;
+
+public:
+  /**
+   * Iterator over the queue in the weight or in the age order
+   *
+   * The queue must not change while the iterator is used.
+   */
+  class Iterator {
+  public:
+    DECL_ELEMENT_TYPE(Clause*);
+
+    Iterator(const ClauseBucketQueue& queue, bool byWeight);
+    bool hasNext() const { return _next; }
+    Clause* next();
+  private:
+    void nextLine();
+
+    const Stack<Bucket*>& _lines;
+    bool _byWeight;
+    unsigned _idx;
+    Bucket* _bucket;
+    Clause* _next;
+  };
+}; // class ClauseBucketQueue
+
+} // namespace Kernel
+
+#endif
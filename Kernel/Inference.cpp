@@ -120,6 +120,16 @@ void Inference::destroy()
   }
 }
 
+void Inference::dropPremises()
+{
+  CALL("Inference::dropPremises");
+
+  destroy();
+  _kind = Kind::INFERENCE_012;
+  _ptr1 = nullptr;
+  _ptr2 = nullptr;
+}
+
 Inference::Inference(const FromSatRefutation& fsr) {
   CALL("Inference::Inference(FromSatRefutation)");
 
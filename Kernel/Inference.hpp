@@ -670,6 +670,11 @@ public:
    * Also does what destroyDirectlyOwned (see above).
    */
   void destroy();
+  /**
+   * Like destroy(), but the inference stays usable, only without premises.
+   * For when the premises are recorded elsewhere, see InferenceArena.
+   */
+  void dropPremises();
 
   /**
    * Since we treat Inferences as PODs, this is intentionally left empty.
@@ -0,0 +1,328 @@
+
+/*
+ * File InferenceArena.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file InferenceArena.cpp
+ * Implements class InferenceArena.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include "Debug/RuntimeStatistics.hpp"
+
+#include "Lib/DArray.hpp"
+#include "Lib/DHSet.hpp"
+#include "Lib/Exception.hpp"
+
+#include "Clause.hpp"
+#include "Inference.hpp"
+
+#include "InferenceArena.hpp"
+
+namespace Kernel
+{
+
+using namespace Lib;
+
+InferenceArena::InferenceArena(bool spill)
+: _spill(spill), _file(0), _fileSize(0)
+{
+}
+
+InferenceArena::~InferenceArena()
+{
+  CALL("InferenceArena::~InferenceArena");
+
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
+  Stack<Chunk>::Iterator cit(_chunks);
+  while (cit.hasNext()) {
+    Chunk& ch = cit.next();
+    if (ch.data) {
+      DEALLOC_KNOWN(ch.data, ch.capacity, "InferenceArena");
+    }
+  }
+  if (_file) {
+    fclose(_file);
+  }
+  DHMap<unsigned,Unit*>::Iterator kit(_kept);
+  while (kit.hasNext()) {
+    kit.next()->decRefCnt();
+  }
+}
+
+/**
+ * Record the derivation of @b cl in the arena and make the clause drop
+ * the references to its premises. Premises which were not archived yet
+ * are archived first.
+ */
+void InferenceArena::archive(Clause* cl)
+{
+  CALL("InferenceArena::archive");
+
+  if (cl->isFromPreprocessing()) {
+    return;
+  }
+
+  static Stack<Clause*> todo;
+  ASS(todo.isEmpty());
+  todo.push(cl);
+  while (todo.isNonEmpty()) {
+    // every clause on the stack is referred to by a clause below it
+    // that is not archived yet, so none of them can get destroyed here
+    Clause* c = todo.top();
+    if (c->inferenceArchived()) {
+      todo.pop();
+      continue;
+    }
+    bool premisesDone = true;
+    Inference& inf = c->inference();
+    Inference::Iterator it = inf.iterator();
+    while (inf.hasNext(it)) {
+      Unit* prem = inf.next(it);
+      if (!prem->isClause() || static_cast<Clause*>(prem)->isFromPreprocessing()) {
+        keep(prem);
+        continue;
+      }
+      Clause* premCl = static_cast<Clause*>(prem);
+      if (!premCl->inferenceArchived()) {
+        todo.push(premCl);
+        premisesDone = false;
+      }
+    }
+    if (!premisesDone) {
+      continue;
+    }
+    todo.pop();
+    append(c);
+    c->markInferenceArchived();
+    c->inference().dropPremises();
+  }
+}
+
+/**
+ * Keep unit @b u for the reconstruction of proofs
+ */
+void InferenceArena::keep(Unit* u)
+{
+  if (_kept.insert(u->number(), u)) {
+    u->incRefCnt();
+  }
+}
+
+/**
+ * Append the record of @b cl
+ */
+void InferenceArena::append(Clause* cl)
+{
+  CALL("InferenceArena::append");
+
+  Inference& inf = cl->inference();
+  _premises.reset();
+  Inference::Iterator it = inf.iterator();
+  while (inf.hasNext(it)) {
+    _premises.push(inf.next(it)->number());
+  }
+
+  RecordHeader h;
+  h.number = cl->number();
+  h.premiseCnt = _premises.size();
+  h.length = cl->length();
+  h.rule = static_cast<unsigned char>(inf.rule());
+  h.inputType = static_cast<unsigned char>(inf.inputType());
+
+  size_t premSize = h.premiseCnt*sizeof(unsigned);
+  size_t litSize = h.length*sizeof(Literal*);
+  char* rec = reserve(sizeof(RecordHeader) + premSize + litSize);
+  // records are not aligned, so they are only accessed through memcpy
+  memcpy(rec, &h, sizeof(RecordHeader));
+  rec += sizeof(RecordHeader);
+  if (premSize) {
+    memcpy(rec, _premises.begin(), premSize);
+    rec += premSize;
+  }
+  if (litSize) {
+    memcpy(rec, cl->literals(), litSize);
+  }
+  RSTAT_CTR_INC("inferences archived");
+}
+
+/**
+ * Return a place for @b size bytes at the end of the arena
+ */
+char* InferenceArena::reserve(size_t size)
+{
+  CALL("InferenceArena::reserve");
+
+  if (_chunks.isEmpty() || _chunks.top().size + size > _chunks.top().capacity) {
+    if (_chunks.isNonEmpty() && _spill) {
+      spill(_chunks.top());
+    }
+    Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
+    Chunk ch;
+    // a record never crosses the end of a chunk
+    ch.capacity = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+    ch.data = static_cast<char*>(ALLOC_KNOWN(ch.capacity, "InferenceArena"));
+    ch.size = 0;
+    ch.filePos = -1;
+    _chunks.push(ch);
+  }
+  Chunk& ch = _chunks.top();
+  char* res = ch.data + ch.size;
+  ch.size += size;
+  return res;
+}
+
+/**
+ * Move the full chunk @b ch to the file. If the file cannot be
+ * created or written, the chunk and all the following ones stay
+ * in memory.
+ */
+void InferenceArena::spill(Chunk& ch)
+{
+  CALL("InferenceArena::spill");
+  ASS(ch.data);
+
+  if (!_file) {
+    _file = tmpfile();
+  }
+  if (!_file || fwrite(ch.data, 1, ch.size, _file) != ch.size) {
+    _spill = false;
+    return;
+  }
+  ch.filePos = _fileSize;
+  _fileSize += ch.size;
+
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
+  DEALLOC_KNOWN(ch.data, ch.capacity, "InferenceArena");
+  ch.data = 0;
+  RSTAT_CTR_INC("inference arena chunks spilled");
+}
+
+/**
+ * Return the content of chunk @b idx, reading it to @b buffer
+ * if it was spilled
+ */
+const char* InferenceArena::chunkData(unsigned idx, DArray<char>& buffer)
+{
+  CALL("InferenceArena::chunkData");
+
+  const Chunk& ch = _chunks[idx];
+  if (ch.data) {
+    return ch.data;
+  }
+  buffer.ensure(ch.size);
+  if (fseek(_file, ch.filePos, SEEK_SET) != 0 || fread(buffer.begin(), 1, ch.size, _file) != ch.size) {
+    SYSTEM_FAIL("Cannot read the inference arena from its temporary file.", errno);
+  }
+  return buffer.begin();
+}
+
+/**
+ * Return a copy of @b refutation whose derivation is rebuilt from the
+ * records, with real premises, up to the units that were not archived
+ */
+Clause* InferenceArena::reconstruct(Clause* refutation)
+{
+  CALL("InferenceArena::reconstruct");
+
+  if (refutation->isFromPreprocessing()) {
+    return refutation;
+  }
+  unsigned refNumber = refutation->number();
+  archive(refutation);
+
+  // Collect the records of the proof, walking from the newest record to the
+  // oldest. As premises are archived before their children, a record is
+  // always reached after all the records that need it.
+  DHSet<unsigned> needed;
+  needed.insert(refNumber);
+  Stack<char> proof;
+  Stack<size_t> proofRecords;
+  DArray<char> buffer;
+  Stack<size_t> offsets;
+  for (unsigned ci = _chunks.size(); ci-- > 0; ) {
+    const char* data = chunkData(ci, buffer);
+    size_t size = _chunks[ci].size;
+    offsets.reset();
+    size_t pos = 0;
+    while (pos < size) {
+      offsets.push(pos);
+      RecordHeader h;
+      memcpy(&h, data + pos, sizeof(RecordHeader));
+      pos += sizeof(RecordHeader) + h.premiseCnt*sizeof(unsigned) + h.length*sizeof(Literal*);
+    }
+    ASS_EQ(pos, size);
+    while (offsets.isNonEmpty()) {
+      const char* rec = data + offsets.pop();
+      RecordHeader h;
+      memcpy(&h, rec, sizeof(RecordHeader));
+      if (!needed.contains(h.number)) {
+        continue;
+      }
+      for (unsigned i = 0; i < h.premiseCnt; i++) {
+        unsigned prem;
+        memcpy(&prem, rec + sizeof(RecordHeader) + i*sizeof(unsigned), sizeof(unsigned));
+        needed.insert(prem);
+      }
+      size_t recSize = sizeof(RecordHeader) + h.premiseCnt*sizeof(unsigned) + h.length*sizeof(Literal*);
+      proofRecords.push(proof.size());
+      for (size_t i = 0; i < recSize; i++) {
+        proof.push(rec[i]);
+      }
+    }
+  }
+
+  // build the clauses from the oldest one
+  DHMap<unsigned,Clause*> rebuilt;
+  Stack<Literal*> lits;
+  Clause* res = 0;
+  while (proofRecords.isNonEmpty()) {
+    const char* rec = proof.begin() + proofRecords.pop();
+    RecordHeader h;
+    memcpy(&h, rec, sizeof(RecordHeader));
+    rec += sizeof(RecordHeader);
+
+    UnitList* premises = UnitList::empty();
+    for (unsigned i = h.premiseCnt; i-- > 0; ) {
+      unsigned prem;
+      memcpy(&prem, rec + i*sizeof(unsigned), sizeof(unsigned));
+      Clause* premCl;
+      Unit* premUnit = rebuilt.find(prem, premCl) ? premCl : _kept.get(prem);
+      UnitList::push(premUnit, premises);
+    }
+    rec += h.premiseCnt*sizeof(unsigned);
+
+    lits.reset();
+    for (unsigned i = 0; i < h.length; i++) {
+      Literal* lit;
+      memcpy(&lit, rec + i*sizeof(Literal*), sizeof(Literal*));
+      lits.push(lit);
+    }
+
+    Inference inf(NonspecificInferenceMany(static_cast<InferenceRule>(h.rule), premises));
+    inf.setInputType(static_cast<UnitInputType>(h.inputType));
+    res = Clause::restore(h.number, h.length, lits.begin(), inf);
+    rebuilt.insert(h.number, res);
+  }
+  ASS(res);
+  ASS_EQ(res->number(), refNumber);
+  return res;
+}
+
+}
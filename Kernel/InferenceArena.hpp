@@ -0,0 +1,118 @@
+
+/*
+ * File InferenceArena.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file InferenceArena.hpp
+ * Defines class InferenceArena.
+ */
+
+#ifndef __InferenceArena__
+#define __InferenceArena__
+
+#include <cstdio>
+
+#include "Forwards.hpp"
+
+#include "Lib/Allocator.hpp"
+#include "Lib/DArray.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Stack.hpp"
+
+namespace Kernel {
+
+using namespace Lib;
+
+/**
+ * Append-only store of the derivation of clauses, kept instead of the
+ * premise pointers of their inferences.
+ *
+ * When a clause is archived, a record with its number, rule, input type,
+ * literals and the numbers of its premises is appended to the arena and the
+ * clause drops the references to its premises. Deleted clauses are then no
+ * longer kept alive by their descendants, while their derivation can still
+ * be printed: reconstruct() walks the records back from a refutation and
+ * builds the clauses of its proof again.
+ *
+ * Premises that are not clauses, or come from preprocessing, are not archived.
+ * They are kept by the arena and the reconstructed proof refers to them.
+ * Premises are always archived before their children, so the records of the
+ * ancestors of a clause lie before its own record.
+ *
+ * Records are written to chunks of CHUNK_SIZE bytes. With spilling, every
+ * full chunk is written to a temporary file and only read back when a proof
+ * is reconstructed.
+ *
+ * The premise pointers of archived clauses are lost, so the arena cannot be
+ * used together with anything that walks the derivation of clauses during
+ * proof search, such as AVATAR or symbol elimination.
+ */
+class InferenceArena
+{
+public:
+  CLASS_NAME(InferenceArena);
+  USE_ALLOCATOR(InferenceArena);
+
+  InferenceArena(bool spill);
+  ~InferenceArena();
+
+  void archive(Clause* cl);
+  Clause* reconstruct(Clause* refutation);
+
+private:
+  /** Fixed size beginning of a record, followed by the premise numbers and the literals */
+  struct RecordHeader
+  {
+    unsigned number;
+    unsigned premiseCnt;
+    unsigned length;
+    unsigned char rule;
+    unsigned char inputType;
+  };
+
+  struct Chunk
+  {
+    /** 0 if the chunk was spilled to the file */
+    char* data;
+    size_t size;
+    size_t capacity;
+    /** position in the file if spilled */
+    long filePos;
+  };
+
+  static const size_t CHUNK_SIZE = 1<<20;
+
+  void keep(Unit* u);
+  void append(Clause* cl);
+  char* reserve(size_t size);
+  void spill(Chunk& ch);
+  const char* chunkData(unsigned idx, DArray<char>& buffer);
+
+  bool _spill;
+  /** file with the spilled chunks, 0 if nothing was spilled yet */
+  FILE* _file;
+  long _fileSize;
+  Stack<Chunk> _chunks;
+  /** units the records refer to that are not archived themselves */
+  DHMap<unsigned,Unit*> _kept;
+  /** premise numbers of the clause being archived */
+  Stack<unsigned> _premises;
+};
+
+}
+
+#endif // __InferenceArena__
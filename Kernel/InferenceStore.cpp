@@ -95,6 +95,7 @@ vstring InferenceStore::getUnitIdStr(Unit* cs)
 void InferenceStore::recordSplittingNameLiteral(Unit* us, Literal* lit)
 {
   CALL("InferenceStore::recordSplittingNameLiteral");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
 
   //each clause is result of a splitting only once
   ALWAYS(_splittingNameLiterals.insert(us, lit));
@@ -107,6 +108,7 @@ void InferenceStore::recordSplittingNameLiteral(Unit* us, Literal* lit)
 void InferenceStore::recordIntroducedSymbol(Unit* u, bool func, unsigned number)
 {
   CALL("InferenceStore::recordIntroducedSymbol");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
 
   SymbolStack* pStack;
   _introducedSymbols.getValuePtr(u->number(),pStack);
@@ -119,9 +121,23 @@ void InferenceStore::recordIntroducedSymbol(Unit* u, bool func, unsigned number)
 void InferenceStore::recordIntroducedSplitName(Unit* u, vstring name)
 {
   CALL("InferenceStore::recordIntroducedSplitName");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
   ALWAYS(_introducedSplitNames.insert(u->number(),name));
 }
 
+/**
+ * Forget what was recorded about @b u, which is being deleted
+ *
+ * Only what is keyed by the address of the unit needs to go.
+ */
+void InferenceStore::onUnitDeleted(Unit* u)
+{
+  CALL("InferenceStore::onUnitDeleted");
+  Allocator::SubsystemScope scope(Allocator::Subsystem::INFERENCE_STORE);
+
+  _splittingNameLiterals.remove(u);
+}
+
 /**
  * Get the parents of unit represented by us and fill in the rule used to generate this unit
  *
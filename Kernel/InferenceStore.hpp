@@ -84,6 +84,7 @@ public:
   void recordSplittingNameLiteral(Unit* us, Literal* lit);
   void recordIntroducedSymbol(Unit* u, bool func, unsigned number);
   void recordIntroducedSplitName(Unit* u, vstring name);
+  void onUnitDeleted(Unit* u);
 
   void outputProof(ostream& out, Unit* refutation);
   void outputProof(ostream& out, UnitList* units);
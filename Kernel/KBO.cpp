@@ -28,11 +28,16 @@
 
 #include "Lib/Environment.hpp"
 #include "Lib/Comparison.hpp"
+#include "Lib/Hash.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Indexing/ResultSubstitution.hpp"
 
 #include "Shell/Options.hpp"
 #include <fstream>
 
 #include "Term.hpp"
+#include "TermIterators.hpp"
 #include "KBO.hpp"
 #include "Signature.hpp"
 
@@ -73,6 +78,7 @@ public:
   Result result(Term* t1, Term* t2);
 private:
   void recordVariable(unsigned var, int coef);
+  void recordVariables(Term* t, int coef);
   Result innerResult(TermList t1, TermList t2);
   Result applyVariableCondition(Result res)
   {
@@ -204,6 +210,14 @@ void KBO::State::traverse(TermList tl,int coef)
   Term* t=tl.term();
   ASSERT_VALID(*t);
 
+  if(t->shared() && _kbo.hasTermWeights()) {
+    _weightDiff+=_kbo.termWeight(t)*coef;
+    if(!t->ground()) {
+      recordVariables(t, coef);
+    }
+    return;
+  }
+
   _weightDiff+=_kbo.symbolWeight(t)*coef;
 
   if(!t->arity()) {
@@ -235,6 +249,37 @@ void KBO::State::traverse(TermList tl,int coef)
   }
 }
 
+/**
+ * Record the variables of the shared non-ground term @b t, skipping
+ * its ground subterms
+ */
+void KBO::State::recordVariables(Term* t, int coef)
+{
+  CALL("KBO::State::recordVariables");
+  ASS(t->shared());
+  ASS(!t->ground());
+
+  TermList* ts=t->args();
+  static Stack<TermList*> stack(4);
+  for(;;) {
+    if(!ts->next()->isEmpty()) {
+      stack.push(ts->next());
+    }
+    if(ts->isTerm()) {
+      if(!ts->term()->ground()) {
+        stack.push(ts->term()->args());
+      }
+    } else {
+      ASS_METHOD(*ts,isOrdinaryVar());
+      recordVariable(ts->var(), coef);
+    }
+    if(stack.isEmpty()) {
+      break;
+    }
+    ts=stack.pop();
+  }
+}
+
 void KBO::State::traverse(Term* t1, Term* t2)
 {
   CALL("KBO::State::traverse");
@@ -504,6 +549,7 @@ KBO::KBO(
   , _state(new State(this))
 { 
   checkAdmissibility(throwError);
+  initTermWeights();
 }
 
 template<class HandleError>
@@ -576,6 +622,39 @@ KBO::KBO(Problem& prb, const Options& opts)
     checkAdmissibility(throwError);
   else
     checkAdmissibility(warnError);
+  initTermWeights();
+}
+
+bool KBO::s_termWeightCacheTaken = false;
+
+/**
+ * Decide how termWeight() gets the weights of terms and clear the cache
+ * of comparisons of ground terms
+ *
+ * With the default weights, the weight of a term is the number of its symbols
+ * and variables, which the term keeps anyway. Otherwise the weights are cached
+ * in the terms, but as there is one place for them in each term, only by the
+ * first ordering that needs it.
+ */
+void KBO::initTermWeights()
+{
+  CALL("KBO::initTermWeights");
+
+  const KboSpecialWeights<FuncSigTraits>& special = _funcWeights._specialWeights;
+  _defaultWeights = _funcWeights._introducedSymbolWeight == 1 && special._variableWeight == 1 &&
+      special._numInt == 1 && special._numRat == 1 && special._numReal == 1;
+  for (unsigned i = 0; _defaultWeights && i < _funcWeights._weights.size(); i++) {
+    _defaultWeights = _funcWeights._weights[i] == 1;
+  }
+
+  _cachesTermWeights = false;
+  if (!_defaultWeights && !s_termWeightCacheTaken) {
+    s_termWeightCacheTaken = true;
+    _cachesTermWeights = true;
+  }
+
+  GroundComparison empty = { 0, 0, INCOMPARABLE };
+  _groundCache.init(GROUND_CACHE_SIZE, empty);
 }
 
 KBO::~KBO()
@@ -649,6 +728,52 @@ Ordering::Result KBO::compare(TermList tl1, TermList tl2) const
   ASS(tl1.isTerm());
   ASS(tl2.isTerm());
 
+  Term* t1=tl1.term();
+  Term* t2=tl2.term();
+  if(t1->shared() && t2->shared() && t1->ground() && t2->ground() && hasTermWeights()) {
+    return compareGround(t1, t2);
+  }
+  return compareByTraversal(tl1, tl2);
+}
+
+/**
+ * Compare distinct shared ground terms, looking into the cache of recent
+ * comparisons if they have the same weight
+ */
+Ordering::Result KBO::compareGround(Term* t1, Term* t2) const
+{
+  CALL("KBO::compareGround");
+  ASS_NEQ(t1, t2);
+
+  KboWeight w1=termWeight(t1);
+  KboWeight w2=termWeight(t2);
+  if(w1!=w2) {
+    return w1>w2 ? GREATER : LESS;
+  }
+
+  // the comparison is cached for the term with the smaller id first
+  bool swapped = t1->getId() > t2->getId();
+  if(swapped) {
+    swap(t1, t2);
+  }
+  unsigned id1=t1->getId();
+  unsigned id2=t2->getId();
+  GroundComparison& entry=_groundCache[HashUtils::combine(id1, id2) & (GROUND_CACHE_SIZE-1)];
+  if(entry.id1!=id1 || entry.id2!=id2) {
+    entry.id1=id1;
+    entry.id2=id2;
+    entry.result=compareByTraversal(TermList(t1), TermList(t2));
+  }
+  return swapped ? reverse(entry.result) : entry.result;
+}
+
+/**
+ * Compare non-variable terms @b tl1 and @b tl2 going through both of them
+ */
+Ordering::Result KBO::compareByTraversal(TermList tl1, TermList tl2) const
+{
+  CALL("KBO::compareByTraversal");
+
   Term* t1=tl1.term();
   Term* t2=tl2.term();
 
@@ -673,6 +798,251 @@ Ordering::Result KBO::compare(TermList tl1, TermList tl2) const
   return res;
 }
 
+/**
+ * Check of lhs&sigma; &gt; rhs&sigma; that works with the images of the
+ * variables of lhs instead of building the instances.
+ *
+ * The weight of lhs&sigma; minus the one of rhs&sigma; is the same difference
+ * for lhs and rhs, plus the weights of the images of variables less the
+ * variable weight, times the number of occurrences of the variable in lhs
+ * minus the one in rhs. The weights of shared terms are known without
+ * traversing them, see KBO::termWeight(). If the instances weigh the same
+ * and the variable condition holds, the precedence of the top functors
+ * decides, or the first pair of arguments whose instances differ.
+ */
+class KBO::KboGreaterCheck
+: public Ordering::GreaterCheck
+{
+public:
+  CLASS_NAME(KBO::KboGreaterCheck);
+  USE_ALLOCATOR(KboGreaterCheck);
+
+  KboGreaterCheck(const KBO& kbo, TermList lhs, TermList rhs, int weightDiff)
+  : _kbo(kbo), _lhs(lhs), _rhs(rhs), _weightDiff(weightDiff), _nonNegative(true) {}
+
+  void addVariable(unsigned var, int coef)
+  {
+    _coefs.push(make_pair(var, coef));
+    _nonNegative &= coef>0;
+  }
+
+  Outcome check(Indexing::ResultSubstitution& subst, bool result) const override;
+private:
+  bool variableCondition(const Stack<TermList>& images) const;
+  Outcome checkSameWeight(Indexing::ResultSubstitution& subst, bool result) const;
+
+  const KBO& _kbo;
+  TermList _lhs;
+  TermList _rhs;
+  /** weight of lhs minus the weight of rhs */
+  int _weightDiff;
+  /** variables with the number of their occurrences in lhs minus the one in rhs, if not zero */
+  Stack<pair<unsigned,int> > _coefs;
+  /** true if no variable occurs more times in rhs than in lhs */
+  bool _nonNegative;
+};
+
+Ordering::GreaterCheck::Outcome KBO::KboGreaterCheck::check(Indexing::ResultSubstitution& subst, bool result) const
+{
+  CALL("KBO::KboGreaterCheck::check");
+
+  static Stack<TermList> images;
+  images.reset();
+
+  int varWeight = _kbo._funcWeights._specialWeights._variableWeight;
+  int weightDiff = _weightDiff;
+  for (unsigned i = 0; i < _coefs.size(); i++) {
+    TermList var(_coefs[i].first, false);
+    TermList img = result ? subst.applyToBoundResult(var) : subst.applyToBoundQuery(var);
+    if (img.isTerm()) {
+      if (!img.term()->shared()) {
+        return MAYBE;
+      }
+      weightDiff += _coefs[i].second*(static_cast<int>(_kbo.termWeight(img.term()))-varWeight);
+    }
+    images.push(img);
+  }
+
+  if (weightDiff<0 || !variableCondition(images)) {
+    return NO;
+  }
+  if (weightDiff>0) {
+    return YES;
+  }
+  return checkSameWeight(subst, result);
+}
+
+/**
+ * Decide lhs&sigma; &gt; rhs&sigma; for instances of the same weight
+ * that satisfy the variable condition
+ */
+Ordering::GreaterCheck::Outcome KBO::KboGreaterCheck::checkSameWeight(Indexing::ResultSubstitution& subst, bool result) const
+{
+  CALL("KBO::KboGreaterCheck::checkSameWeight");
+
+  if (_rhs.isVar()) {
+    return MAYBE;
+  }
+  const Term* l = _lhs.term();
+  const Term* r = _rhs.term();
+  if (l->functor()!=r->functor()) {
+    return _kbo.compareFunctionPrecedences(l->functor(), r->functor())==GREATER ? YES : NO;
+  }
+  for (unsigned i = 0; i < l->arity(); i++) {
+    TermList la = *l->nthArgument(i);
+    TermList ra = *r->nthArgument(i);
+    if (la==ra) {
+      continue;
+    }
+    TermList laS = result ? subst.applyToBoundResult(la) : subst.applyToBoundQuery(la);
+    TermList raS = result ? subst.applyToBoundResult(ra) : subst.applyToBoundQuery(ra);
+    Result res = _kbo.compare(laS, raS);
+    if (res!=EQUAL) {
+      return res==GREATER ? YES : NO;
+    }
+  }
+  // the instances are equal
+  return NO;
+}
+
+/**
+ * True if no variable occurs in rhs&sigma; more times than in lhs&sigma;,
+ * where @b images are the images of the variables in _coefs under &sigma;
+ */
+bool KBO::KboGreaterCheck::variableCondition(const Stack<TermList>& images) const
+{
+  CALL("KBO::KboGreaterCheck::variableCondition");
+
+  if (_nonNegative) {
+    return true;
+  }
+  static DHMap<unsigned,int> varDiffs;
+  varDiffs.reset();
+  for (unsigned i = 0; i < _coefs.size(); i++) {
+    VariableIterator vit(images[i]);
+    while (vit.hasNext()) {
+      int* diff;
+      varDiffs.getValuePtr(vit.next().var(), diff, 0);
+      *diff += _coefs[i].second;
+    }
+  }
+  DHMap<unsigned,int>::Iterator dit(varDiffs);
+  while (dit.hasNext()) {
+    if (dit.next()<0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Ordering::GreaterCheck* KBO::prepareGreaterCheck(TermList lhs, TermList rhs) const
+{
+  CALL("KBO::prepareGreaterCheck");
+
+  // variables and special terms are left to compare()
+  if (!hasTermWeights() || lhs.isVar() || !lhs.term()->shared() ||
+      (rhs.isTerm() && !rhs.term()->shared())) {
+    return 0;
+  }
+
+  int varWeight = _funcWeights._specialWeights._variableWeight;
+  int lhsWeight = termWeight(lhs.term());
+  int rhsWeight = rhs.isVar() ? varWeight : termWeight(rhs.term());
+  KboGreaterCheck* res = new KboGreaterCheck(*this, lhs, rhs, lhsWeight-rhsWeight);
+
+  static DHMap<unsigned,int> occurrences;
+  occurrences.reset();
+  VariableIterator lit(lhs);
+  while (lit.hasNext()) {
+    int* occ;
+    occurrences.getValuePtr(lit.next().var(), occ, 0);
+    (*occ)++;
+  }
+  VariableIterator rit(rhs);
+  while (rit.hasNext()) {
+    int* occ;
+    ALWAYS(!occurrences.getValuePtr(rit.next().var(), occ, 0));
+    (*occ)--;
+  }
+  DHMap<unsigned,int>::Iterator oit(occurrences);
+  while (oit.hasNext()) {
+    unsigned var;
+    int occ;
+    oit.next(var, occ);
+    if (occ) {
+      res->addVariable(var, occ);
+    }
+  }
+  return res;
+}
+
+/**
+ * Return the weight of the shared term @b t
+ */
+KboWeight KBO::termWeight(Term* t) const
+{
+  CALL("KBO::termWeight");
+  ASS(t->shared());
+
+  if(_defaultWeights) {
+    return t->weight();
+  }
+  if(!_cachesTermWeights) {
+    return computeTermWeight(t);
+  }
+  // the cache keeps the weight plus one, so that 0 can mean unknown
+  if(!t->kboWeight()) {
+    // fill in the weights of the subterms first, so that each is computed
+    // from the cached weights of its arguments
+    static Stack<Term*> stack(8);
+    stack.push(t);
+    while(stack.isNonEmpty()) {
+      Term* s=stack.top();
+      KboWeight w=symbolWeight(s);
+      bool argsKnown=true;
+      for(TermList* ts=s->args(); !ts->isEmpty(); ts=ts->next()) {
+        if(ts->isVar()) {
+          w+=_funcWeights._specialWeights._variableWeight;
+        } else if(ts->term()->kboWeight()) {
+          w+=ts->term()->kboWeight()-1;
+        } else {
+          argsKnown=false;
+          stack.push(ts->term());
+        }
+      }
+      if(argsKnown) {
+        s->setKboWeight(w+1);
+        stack.pop();
+      }
+    }
+  }
+  return t->kboWeight()-1;
+}
+
+/**
+ * Return the weight of the term @b t, going through the whole term
+ */
+KboWeight KBO::computeTermWeight(Term* t) const
+{
+  CALL("KBO::computeTermWeight");
+
+  KboWeight w=0;
+  static Stack<TermList> stack(8);
+  stack.push(TermList(t));
+  while(stack.isNonEmpty()) {
+    TermList tl=stack.pop();
+    if(tl.isVar()) {
+      w+=_funcWeights._specialWeights._variableWeight;
+      continue;
+    }
+    w+=symbolWeight(tl.term());
+    for(TermList* ts=tl.term()->args(); !ts->isEmpty(); ts=ts->next()) {
+      stack.push(*ts);
+    }
+  }
+  return w;
+}
+
 int KBO::symbolWeight(Term* t) const
 {
 #if __KBO__CUSTOM_PREDICATE_WEIGHTS__
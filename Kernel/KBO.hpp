@@ -162,16 +162,26 @@ public:
 
   using PrecedenceOrdering::compare;
   Result compare(TermList tl1, TermList tl2) const override;
+  GreaterCheck* prepareGreaterCheck(TermList lhs, TermList rhs) const override;
 protected:
   Result comparePredicates(Literal* l1, Literal* l2) const override;
 
 
   class State;
+  class KboGreaterCheck;
 
   // int functionSymbolWeight(unsigned fun) const;
   int symbolWeight(Term* t) const;
 
+  /** True if termWeight() does not need to traverse the term */
+  bool hasTermWeights() const { return _defaultWeights || _cachesTermWeights; }
+  KboWeight termWeight(Term* t) const;
+
 private:
+  void initTermWeights();
+  KboWeight computeTermWeight(Term* t) const;
+  Result compareGround(Term* t1, Term* t2) const;
+  Result compareByTraversal(TermList tl1, TermList tl2) const;
 
   KboWeightMap<FuncSigTraits> _funcWeights;
 #if __KBO__CUSTOM_PREDICATE_WEIGHTS__
@@ -189,6 +199,24 @@ private:
    * State used for comparing terms and literals
    */
   mutable State* _state;
+
+  /** True if all symbols and variables weigh 1, so that the weight of a term is Term::weight() */
+  bool _defaultWeights;
+  /** True if this ordering keeps the weights of terms in Term::kboWeight() */
+  bool _cachesTermWeights;
+  /** True once an ordering took Term::kboWeight() for itself */
+  static bool s_termWeightCacheTaken;
+
+  /** Result of comparing the ground terms with ids id1 &lt; id2 of the same weight */
+  struct GroundComparison
+  {
+    unsigned id1;
+    unsigned id2;
+    Result result;
+  };
+  static const unsigned GROUND_CACHE_SIZE = 1024;
+  /** Recent comparisons of ground terms, indexed by a hash of the ids */
+  mutable DArray<GroundComparison> _groundCache;
 };
 
 }
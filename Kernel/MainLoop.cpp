@@ -76,6 +76,26 @@ MainLoopResult MainLoop::run()
     init();
     return runImpl();
   }
+  catch(...)
+  {
+    return terminationResult();
+  }
+}
+
+/**
+ * Return the result of the main loop that was terminated by the exception
+ * currently being handled. Exceptions that do not terminate the main loop
+ * are thrown further.
+ *
+ * Must only be called from within a catch block.
+ */
+MainLoopResult MainLoop::terminationResult()
+{
+  CALL("MainLoop::terminationResult");
+
+  try {
+    throw;
+  }
   catch(RefutationFoundException& rs)
   {
     return MainLoopResult(Statistics::REFUTATION, rs.refutation);
@@ -133,6 +133,8 @@ protected:
    */
   virtual MainLoopResult runImpl() = 0;
 
+  static MainLoopResult terminationResult();
+
   Problem& _prb;
 
   /**
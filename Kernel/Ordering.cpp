@@ -72,6 +72,11 @@ Ordering::~Ordering()
   destroyEqualityComparator();
 }
 
+Ordering::GreaterCheck* Ordering::prepareGreaterCheck(TermList lhs, TermList rhs) const
+{
+  return 0;
+}
+
 
 /**
  * If there is no global ordering yet, assign @c ordering to be
@@ -77,6 +77,41 @@ public:
 
   virtual void show(ostream& out) const = 0;
 
+  /**
+   * Check of whether instances of one term are greater than the
+   * corresponding instances of another one, prepared in advance
+   * for terms that are compared under many substitutions
+   */
+  class GreaterCheck
+  {
+  public:
+    CLASS_NAME(Ordering::GreaterCheck);
+    USE_ALLOCATOR(Ordering::GreaterCheck);
+
+    enum Outcome {
+      YES,
+      NO,
+      /** the terms have to be compared */
+      MAYBE
+    };
+
+    virtual ~GreaterCheck() {}
+    /**
+     * Decide whether lhs&sigma; &gt; rhs&sigma; for the terms the check was
+     * prepared for, where &sigma; is the substitution @b subst applied to
+     * result terms if @b result is true and to query terms otherwise.
+     * All the variables of both terms must be bound in @b subst.
+     */
+    virtual Outcome check(Indexing::ResultSubstitution& subst, bool result) const = 0;
+  };
+
+  /**
+   * Return a check of lhs&sigma; &gt; rhs&sigma; for @b lhs and @b rhs, or 0 if
+   * the ordering cannot decide it faster than by comparing the instances.
+   * The variables of @b rhs must occur in @b lhs. The caller owns the result.
+   */
+  virtual GreaterCheck* prepareGreaterCheck(TermList lhs, TermList rhs) const;
+
   static bool isGorGEorE(Result r) { return (r == GREATER || r == GREATER_EQ || r == EQUAL); }
 
   virtual Comparison compareFunctors(unsigned fun1, unsigned fun2) const = 0;
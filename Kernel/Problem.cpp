@@ -92,6 +92,79 @@ Problem::~Problem()
   UnitList::destroy(_units);
 }
 
+/**
+ * Push @b cl and its clause ancestors from preprocessing that do not
+ * have the auxiliary mark to @b res, and mark them
+ */
+void Problem::collectPreprocessingAncestors(Clause* cl, Stack<Clause*>& res)
+{
+  CALL("Problem::collectPreprocessingAncestors");
+
+  static Stack<Clause*> todo;
+  ASS(todo.isEmpty());
+  todo.push(cl);
+  while(todo.isNonEmpty()) {
+    Clause* c = todo.pop();
+    if(c->hasAux() || !c->isFromPreprocessing()) {
+      continue;
+    }
+    c->setAux();
+    res.push(c);
+    Inference& inf = c->inference();
+    Inference::Iterator iit = inf.iterator();
+    while(inf.hasNext(iit)) {
+      Unit* prem = inf.next(iit);
+      if(prem->isClause()) {
+        todo.push(static_cast<Clause*>(prem));
+      }
+    }
+  }
+}
+
+/**
+ * Give up the units of the problem, the references to clauses taken
+ * by addUnits and the references with which the clauses of the problem
+ * and their ancestors from preprocessing were created.
+ *
+ * From then on these clauses are owned by the reference counting holders
+ * only. Those not referred to from elsewhere, including the ones removed
+ * from the problem during preprocessing, are destroyed. The problem is
+ * left empty, while the property keeps describing the units it had.
+ */
+void Problem::releaseClauses()
+{
+  CALL("Problem::releaseClauses");
+
+  // collect the clauses before any of them can be destroyed; formulas
+  // are not derived from clauses, so the clause ancestors of a clause
+  // are reached through clauses only
+  Stack<Clause*> preprocessed;
+  Clause::requestAux();
+  UnitList::Iterator uit(_units);
+  while(uit.hasNext()) {
+    Unit* u = uit.next();
+    if(u->isClause()) {
+      collectPreprocessingAncestors(static_cast<Clause*>(u), preprocessed);
+    }
+  }
+  Stack<Clause*>::Iterator rit(_referencedClauses);
+  while(rit.hasNext()) {
+    collectPreprocessingAncestors(rit.next(), preprocessed);
+  }
+  Clause::releaseAux();
+
+  while(_referencedClauses.isNonEmpty()) {
+    _referencedClauses.pop()->decRefCnt();
+  }
+  UnitList::destroy(_units);
+  _units = UnitList::empty();
+  // a clause is only destroyed when its own reference goes, so the
+  // ones still on the stack are alive
+  while(preprocessed.isNonEmpty()) {
+    preprocessed.pop()->decRefCnt();
+  }
+}
+
 /**
  * Initialize values of information in the problem
  *
@@ -126,6 +199,7 @@ void Problem::addUnits(UnitList* newUnits)
     Unit* u = uit.next();
     if(u->isClause()) {
       static_cast<Clause*>(u)->incRefCnt();
+      _referencedClauses.push(static_cast<Clause*>(u));
     }
   }
   _units = UnitList::concat(newUnits, _units);
@@ -262,6 +336,8 @@ void Problem::addEliminatedPredicate(unsigned pred, Unit* definition)
 {
   CALL("Problem::addEliminatedPredicate");
 
+  // the definition is needed for model output even if no clause refers to it
+  definition->incRefCnt();
   _deletedPredicates.insert(pred,definition);
 }
 
@@ -274,6 +350,7 @@ void Problem::addPartiallyEliminatedPredicate(unsigned pred, Unit* definition)
 {
   CALL("Problem::addPurePredicateDefinition");
 
+  definition->incRefCnt();
   _partiallyDeletedPredicates.insert(pred,definition);
 }
 
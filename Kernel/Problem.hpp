@@ -28,6 +28,7 @@
 
 #include "Lib/DHMap.hpp"
 #include "Lib/MaybeBool.hpp"
+#include "Lib/Stack.hpp"
 
 #include "Shell/SMTLIBLogic.hpp"
 
@@ -67,6 +68,7 @@ public:
   ~Problem();
 
   void addUnits(UnitList* newUnits);
+  void releaseClauses();
 
   UnitList*& units() { return _units; }
   const UnitList* units() const { return _units; }
@@ -201,11 +203,14 @@ public:
 private:
 
   void initValues();
+  static void collectPreprocessingAncestors(Clause* cl, Stack<Clause*>& res);
 
   void refreshProperty() const;
   void readDetailsFromProperty() const;
 
   UnitList* _units;
+  /** clauses whose reference counter was increased by addUnits */
+  Stack<Clause*> _referencedClauses;
   DHMap<unsigned,Literal*> _deletedFunctions;
   DHMap<unsigned,Unit*> _deletedPredicates;
   DHMap<unsigned,Unit*> _partiallyDeletedPredicates; 
@@ -21,6 +21,8 @@
  * Implements class Signature for handling signatures
  */
 
+#include <cstring>
+
 #include "Lib/Environment.hpp"
 #include "Lib/Int.hpp"
 #include "Shell/Options.hpp"
@@ -56,10 +58,7 @@ Signature::Symbol::Symbol(const vstring& nm,unsigned arity, bool interpreted, bo
     _termAlgebraCons(0),
     _type(0),
     _distinctGroups(0),
-    _usageCount(0),
-    _unitUsageCount(0),
-    _inGoal(0),
-    _inUnit(0),
+    _usage(0),
     _inductionSkolem(0),
     _skolem(0)
 {
@@ -209,6 +208,7 @@ OperatorType* Signature::Symbol::predType() const
  */
 Signature::Signature ():
     _foolConstantsDefined(false), _foolTrue(0), _foolFalse(0),
+    _usageChunkUsed(USAGE_CHUNK_SIZE),
     _funs(32),
     _preds(32),
     _nextFreshSymbolNumber(0),
@@ -244,8 +244,29 @@ Signature::~Signature ()
   for (int i = _preds.length()-1;i >= 0;i--) {
     _preds[i]->destroyPredSymbol();
   }
+  while (_usageChunks.isNonEmpty()) {
+    DEALLOC_KNOWN(_usageChunks.pop(), USAGE_CHUNK_SIZE*sizeof(SymbolUsage), "Signature::SymbolUsage");
+  }
 } // Signature::~Signature
 
+/**
+ * Give the new symbol @b sym a zeroed usage record and return it
+ */
+Signature::Symbol* Signature::withUsage(Symbol* sym)
+{
+  CALL("Signature::withUsage");
+  ASS(!sym->_usage);
+
+  if (_usageChunkUsed == USAGE_CHUNK_SIZE) {
+    void* mem = ALLOC_KNOWN(USAGE_CHUNK_SIZE*sizeof(SymbolUsage), "Signature::SymbolUsage");
+    memset(mem, 0, USAGE_CHUNK_SIZE*sizeof(SymbolUsage));
+    _usageChunks.push(static_cast<SymbolUsage*>(mem));
+    _usageChunkUsed = 0;
+  }
+  sym->_usage = _usageChunks.top() + _usageChunkUsed++;
+  return sym;
+} // Signature::withUsage
+
 /**
  * Add an integer constant to the signature. If defaultSort is true, treat it as
  * a term of the default sort, otherwise as an interepreted integer value.
@@ -277,7 +298,7 @@ unsigned Signature::addIntegerConstant(const vstring& number,bool defaultSort)
      sym->addToDistinctGroup(STRING_DISTINCT_GROUP,result); // numbers are disctinct from strings
   }
   */
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(symbolKey,result);
   return result;
 } // Signature::addIntegerConstant
@@ -298,7 +319,7 @@ unsigned Signature::addIntegerConstant(const IntegerConstantType& value)
   _integers++;
   result = _funs.length();
   Symbol* sym = new IntegerSymbol(value);
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(key,result);
   /*
   sym->addToDistinctGroup(INTEGER_DISTINCT_GROUP,result);
@@ -335,7 +356,7 @@ unsigned Signature::addRationalConstant(const vstring& numerator, const vstring&
   }
   sym->addToDistinctGroup(RATIONAL_DISTINCT_GROUP,result);
   */
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(key,result);
   return result;
 } // addRatonalConstant
@@ -351,7 +372,7 @@ unsigned Signature::addRationalConstant(const RationalConstantType& value)
   }
   _rationals++;
   result = _funs.length();
-  _funs.push(new RationalSymbol(value));
+  _funs.push(withUsage(new RationalSymbol(value)));
   _funNames.insert(key, result);
   return result;
 } // Signature::addRationalConstant
@@ -383,7 +404,7 @@ unsigned Signature::addRealConstant(const vstring& number,bool defaultSort)
   }
   sym->addToDistinctGroup(REAL_DISTINCT_GROUP,result);
   */
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(key,result);
   return result;
 } // addRealConstant
@@ -399,7 +420,7 @@ unsigned Signature::addRealConstant(const RealConstantType& value)
   }
   _reals++;
   result = _funs.length();
-  _funs.push(new RealSymbol(value));
+  _funs.push(withUsage(new RealSymbol(value)));
   _funNames.insert(key, result);
   return result;
 }
@@ -427,7 +448,7 @@ unsigned Signature::addInterpretedFunction(Interpretation interpretation, Operat
 
   unsigned fnNum = _funs.length();
   InterpretedSymbol* sym = new InterpretedSymbol(name, interpretation);
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(symbolKey, fnNum);
   ALWAYS(_iSymbols.insert(mi, fnNum));
 
@@ -465,7 +486,7 @@ unsigned Signature::addInterpretedPredicate(Interpretation interpretation, Opera
 
   unsigned predNum = _preds.length();
   InterpretedSymbol* sym = new InterpretedSymbol(name, interpretation);
-  _preds.push(sym);
+  _preds.push(withUsage(sym));
   _predNames.insert(symbolKey,predNum);
   ALWAYS(_iSymbols.insert(mi, predNum));
   if (predNum!=0) {
@@ -638,7 +659,7 @@ unsigned Signature::addFunction (const vstring& name,
   }
 
   result = _funs.length();
-  _funs.push(new Symbol(name, arity, false, false, false, overflowConstant));
+  _funs.push(withUsage(new Symbol(name, arity, false, false, false, overflowConstant)));
   _funNames.insert(symbolKey, result);
   added = true;
   return result;
@@ -664,7 +685,7 @@ unsigned Signature::addStringConstant(const vstring& name)
   result = _funs.length();
   Symbol* sym = new Symbol(quotedName,0,false,true);
   sym->addToDistinctGroup(STRING_DISTINCT_GROUP,result);
-  _funs.push(sym);
+  _funs.push(withUsage(sym));
   _funNames.insert(symbolKey,result);
   return result;
 } // addStringConstant
@@ -709,7 +730,7 @@ unsigned Signature::addPredicate (const vstring& name,
   }
 
   result = _preds.length();
-  _preds.push(new Symbol(name,arity));
+  _preds.push(withUsage(new Symbol(name,arity)));
   _predNames.insert(symbolKey,result);
   added = true;
   return result;
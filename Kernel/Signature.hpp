@@ -57,6 +57,24 @@ using namespace Lib;
 class Signature
 {
  public:
+  /**
+   * Counts and marks of a symbol in the current problem. Property resets
+   * and recomputes them on every scan, which each forked proving process
+   * does when it preprocesses the problem. They are kept densely in chunks
+   * rather than in the symbols, so that these processes write to a few pages
+   * and the pages holding the symbols stay shared with their parent.
+   */
+  struct SymbolUsage {
+    /** number of times the symbol is used in the problem */
+    unsigned usageCount;
+    /** number of units it is used in in the problem */
+    unsigned unitUsageCount;
+    /** if used in the goal **/
+    unsigned inGoal : 1;
+    /** if used in a unit **/
+    unsigned inUnit : 1;
+  };
+
   /** Function or predicate symbol */
   class Symbol {
   protected:
@@ -93,14 +111,8 @@ class Signature
     mutable OperatorType* _type;
     /** List of distinct groups the constant is a member of, all members of a distinct group should be distinct from each other */
     List<unsigned>* _distinctGroups;
-    /** number of times it is used in the problem */
-    unsigned _usageCount;
-    /** number of units it is used in in the problem */
-    unsigned _unitUsageCount;
-    /** if used in the goal **/
-    unsigned _inGoal : 1;
-    /** if used in a unit **/
-    unsigned _inUnit : 1;
+    /** usage in the problem, assigned by the signature */
+    SymbolUsage* _usage;
     /** if induction skolem **/
     unsigned _inductionSkolem : 1;
     /** if skolem function in general **/
@@ -164,20 +176,20 @@ class Signature
     inline bool termAlgebraCons() const { return _termAlgebraCons; }
 
     /** Increase the usage count of this symbol **/
-    inline void incUsageCnt(){ _usageCount++; }
+    inline void incUsageCnt(){ _usage->usageCount++; }
     /** Return the usage count of this symbol **/
-    inline unsigned usageCnt() const { return _usageCount; }
+    inline unsigned usageCnt() const { return _usage->usageCount; }
     /** Reset usage count to zero, to start again! **/
-    inline void resetUsageCnt(){ _usageCount=0; }
+    inline void resetUsageCnt(){ _usage->usageCount=0; }
 
-    inline void incUnitUsageCnt(){ _unitUsageCount++;}
-    inline unsigned unitUsageCnt() const { return _unitUsageCount; }
-    inline void resetUnitUsageCnt(){ _unitUsageCount=0;}
+    inline void incUnitUsageCnt(){ _usage->unitUsageCount++;}
+    inline unsigned unitUsageCnt() const { return _usage->unitUsageCount; }
+    inline void resetUnitUsageCnt(){ _usage->unitUsageCount=0;}
 
-    inline void markInGoal(){ _inGoal=1; }
-    inline bool inGoal(){ return _inGoal; }
-    inline void markInUnit(){ _inUnit=1; }
-    inline bool inUnit(){ return _inUnit; }
+    inline void markInGoal(){ _usage->inGoal=1; }
+    inline bool inGoal(){ return _usage->inGoal; }
+    inline void markInUnit(){ _usage->inUnit=1; }
+    inline bool inUnit(){ return _usage->inUnit; }
 
     inline void markSkolem(){ _skolem = 1;}
     inline bool skolem(){ return _skolem; }
@@ -222,6 +234,8 @@ class Signature
 
     CLASS_NAME(Signature::Symbol);
     USE_ALLOCATOR(Symbol);
+
+    friend class Signature;
   }; // class Symbol
 
   class InterpretedSymbol
@@ -533,6 +547,14 @@ private:
 
   static bool isProtectedName(vstring name);
   static bool charNeedsQuoting(char c, bool first);
+  Symbol* withUsage(Symbol* sym);
+
+  static const unsigned USAGE_CHUNK_SIZE = 1024;
+  /** chunks of USAGE_CHUNK_SIZE usage records of the symbols */
+  Stack<SymbolUsage*> _usageChunks;
+  /** number of records given out from the last chunk */
+  unsigned _usageChunkUsed;
+
   /** Stack of function symbols */
   Stack<Symbol*> _funs;
   /** Stack of predicate symbols */
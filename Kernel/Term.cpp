@@ -75,6 +75,7 @@ void* Term::operator new(size_t,unsigned arity, size_t preData)
   ASS_EQ(preData%sizeof(size_t), 0);
 
   size_t sz = sizeof(Term)+arity*sizeof(TermList)+preData;
+  Allocator::SubsystemScope scope(Allocator::Subsystem::TERMS);
   void* mem = ALLOC_KNOWN(sz,"Term");
   mem = reinterpret_cast<void*>(reinterpret_cast<char*>(mem)+preData);
   return (Term*)mem;
@@ -94,6 +95,7 @@ void Term::destroy ()
   size_t sz = sizeof(Term)+_arity*sizeof(TermList);
   void* mem = this;
   mem = reinterpret_cast<void*>(reinterpret_cast<char*>(mem)+getPreDataSize()); // MS: shouldn't here be "-getPreDataSize()" to complement the "operator new" above?
+  Allocator::SubsystemScope scope(Allocator::Subsystem::TERMS);
   DEALLOC_KNOWN(mem,sz,"Term");
 } // Term::destroy
 
@@ -1353,7 +1355,8 @@ Term::Term(const Term& t) throw()
     _hasInterpretedConstants(0),
     _isTwoVarEquality(0),
     _weight(0),
-    _vars(0)
+    _vars(0),
+    _kboWeight(0)
 {
   CALL("Term::Term/1");
   ASS(!isSpecial()); //we do not copy special terms
@@ -1382,7 +1385,8 @@ Term::Term() throw()
    _hasInterpretedConstants(0),
    _isTwoVarEquality(0),
    _weight(0),
-   _vars(0)
+   _vars(0),
+   _kboWeight(0)
 {
   CALL("Term::Term/0");
 
@@ -420,6 +420,21 @@ public:
     _weight = w;
   } // setWeight
 
+  /**
+   * Weight of the term under the KBO that caches its weights in terms,
+   * or 0 if not computed yet (see KBO::termWeight())
+   */
+  unsigned kboWeight() const
+  {
+    ASS(shared());
+    return _kboWeight;
+  }
+  /** Set the cached KBO weight */
+  void setKboWeight(unsigned w)
+  {
+    _kboWeight = w;
+  }
+
   /** Set term id */
   void setId(unsigned id)
   {
@@ -651,6 +666,8 @@ protected:
      * the sort of the top-level variables */
     unsigned _sort;
   };
+  /** Cached KBO weight, fits in the padding before _args on 64-bit platforms */
+  unsigned _kboWeight;
 
 #if USE_MATCH_TAG && !ARCH_X64
   MatchTag _matchTag;
@@ -58,9 +58,11 @@ void Unit::onPreprocessingEnd()
   _firstNonPreprocessingNumber=_lastNumber+1;
 }
 
-/** New unit of a given kind */
-Unit::Unit(Kind kind,const Inference& inf)
-  : _number(++_lastNumber),
+/**
+ * New unit of a given kind, with a new number unless @b number is non-zero
+ */
+Unit::Unit(Kind kind,const Inference& inf,unsigned number)
+  : _number(number ? number : ++_lastNumber),
     _kind(kind),
     _inheritedColor(COLOR_INVALID),
     _inference(inf)
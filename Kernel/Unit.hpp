@@ -160,7 +160,7 @@ protected:
   /** inference used to obtain the unit */
   Inference _inference;
 
-  Unit(Kind kind, const Inference& inf);
+  Unit(Kind kind, const Inference& inf, unsigned number = 0);
 
   /** Used to enumerate units */
   static unsigned _lastNumber;
@@ -101,6 +101,10 @@ size_t Allocator::_tolerated;
 Allocator* Allocator::current;
 Allocator::Page* Allocator::_pages[MAX_PAGES];
 size_t Allocator::_usedMemory = 0;
+long long Allocator::_subsystemUsage[SUBSYSTEM_CNT];
+Allocator::Subsystem Allocator::_subsystem = Allocator::Subsystem::OTHER;
+size_t Allocator::_memoryPressureLimit = 0;
+bool Allocator::_underMemoryPressure = false;
 Allocator* Allocator::_all[MAX_ALLOCATORS];
 
 #if VDEBUG
@@ -142,6 +146,28 @@ void Allocator::operator delete(void* obj) {
   free(obj);
 }
 
+const char* Allocator::subsystemName(Subsystem s)
+{
+  switch(s) {
+  case Subsystem::OTHER:
+    return "other";
+  case Subsystem::TERMS:
+    return "terms";
+  case Subsystem::CLAUSES:
+    return "clauses";
+  case Subsystem::INDICES:
+    return "indices";
+  case Subsystem::PASSIVE:
+    return "passive";
+  case Subsystem::SAT_SOLVER:
+    return "SAT solver";
+  case Subsystem::INFERENCE_STORE:
+    return "inference store";
+  }
+  ASSERTION_VIOLATION;
+  return 0;
+} // Allocator::subsystemName
+
 /**
  * Create a new allocator.
  * @since 10/01/2008 Manchester
@@ -160,6 +186,72 @@ Allocator::Allocator()
 #endif
 } // Allocator::Allocator
 
+/**
+ * Stop reusing the free pieces, to be called in a forked child process.
+ *
+ * The free pieces lie on pages holding objects of the parent process, and
+ * writing an object to one of them makes the kernel copy the whole page.
+ * Objects of the child rather go to pages of its own, while the forgotten
+ * pieces stay shared with the parent. They no longer count as used memory
+ * of the child, so that they do not use up its memory limit, which would
+ * otherwise shrink with every nested fork. Whole free pages are still
+ * reused, as they cost the child a copy either way.
+ *
+ * Only registered as a fork handler with the option fork_keeps_pieces_shared.
+ */
+void Allocator::forgetFreePieces()
+{
+  CALLC("Allocator::forgetFreePieces",MAKE_CALLS);
+
+#if ! USE_SYSTEM_ALLOCATION
+  size_t forgotten = 0;
+  for (int a = 0;a < _total;a++) {
+    for (int i = REQUIRES_PAGE/4-1;i >= 0;i--) {
+      for (Known* k = _all[a]->_freeList[i]; k; k = k->next) {
+        forgotten += (i+1)*sizeof(Known);
+      }
+      _all[a]->_freeList[i] = 0;
+    }
+  }
+  ASS_LE(forgotten, _usedMemory);
+  _usedMemory -= forgotten;
+#endif
+} // Allocator::forgetFreePieces
+
+/**
+ * Count @b size bytes that were allocated outside of the allocator,
+ * e.g. by a worker thread which must not use it, as used memory.
+ * Throw MemoryLimitExceededException if this exceeds the memory limit.
+ * The memory must be given back by releaseExternalMemory.
+ */
+void Allocator::chargeExternalMemory(size_t size)
+{
+  CALLC("Allocator::chargeExternalMemory",MAKE_CALLS);
+
+  size_t newSize = _usedMemory+size;
+  if (_tolerated && newSize > _tolerated) {
+    env.statistics->terminationReason = Shell::Statistics::MEMORY_LIMIT;
+    //increase the limit, so that the exception can be handled properly.
+    _tolerated=newSize+1000000;
+    throw Lib::MemoryLimitExceededException();
+  }
+  _usedMemory = newSize;
+  if (_memoryPressureLimit && newSize > _memoryPressureLimit) {
+    _underMemoryPressure = true;
+  }
+} // Allocator::chargeExternalMemory
+
+/**
+ * Stop counting @b size bytes charged by chargeExternalMemory as used memory
+ */
+void Allocator::releaseExternalMemory(size_t size)
+{
+  CALLC("Allocator::releaseExternalMemory",MAKE_CALLS);
+
+  ASS_LE(size, _usedMemory);
+  _usedMemory -= size;
+} // Allocator::releaseExternalMemory
+
 /**
  * Returns all pages to the global manager.
  * 
@@ -352,6 +444,8 @@ void Allocator::deallocateKnown(void* obj,size_t size)
   CALLC("Allocator::deallocateKnown",MAKE_CALLS);
   ASS(obj);
 
+  _subsystemUsage[static_cast<unsigned>(_subsystem)] -= size;
+
 #if VDEBUG
   Descriptor* desc = Descriptor::find(obj);
   desc->timestamp = ++Descriptor::globalTimestamp;
@@ -425,6 +519,8 @@ void Allocator::deallocateUnknown(void* obj)
 {
   CALLC("Allocator::deallocateUnknown",MAKE_CALLS);
 
+  _subsystemUsage[static_cast<unsigned>(_subsystem)] -= unknownsSize(obj) + sizeof(Known);
+
 #if VDEBUG
   Descriptor* desc = Descriptor::find(obj);
   desc->timestamp = ++Descriptor::globalTimestamp;
@@ -619,6 +715,9 @@ Allocator::Page* Allocator::allocatePages(size_t size)
 #endif
     }
     _usedMemory = newSize;
+    if (_memoryPressureLimit && newSize > _memoryPressureLimit) {
+      _underMemoryPressure = true;
+    }
 
     char* mem = static_cast<char*>(malloc(realSize));
     if (!mem) {
@@ -773,6 +872,7 @@ void* Allocator::allocateKnown(size_t size)
   ASS(size > 0);
 
   char* result = allocatePiece(size);
+  _subsystemUsage[static_cast<unsigned>(_subsystem)] += size;
 
 #if VDEBUG
   Descriptor* desc = Descriptor::find(result);
@@ -895,6 +995,7 @@ void* Allocator::allocateUnknown(size_t size)
 
   size += sizeof(Known);
   char* result = allocatePiece(size);
+  _subsystemUsage[static_cast<unsigned>(_subsystem)] += size;
   Unknown* unknown = reinterpret_cast<Unknown*>(result);
   unknown->size = size;
   result += sizeof(Known);
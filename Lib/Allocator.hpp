@@ -97,6 +97,71 @@ public:
     _memoryLimit = size;
     _tolerated = size + (size/10);
   }
+  /**
+   * Return the number of bytes that can still be used before the memory
+   * limit is exceeded, or the largest size_t if there is no limit
+   */
+  static size_t getAvailableMemory()
+  {
+    CALLC("Allocator::getAvailableMemory",MAKE_CALLS);
+    if (!_tolerated) {
+      return static_cast<size_t>(-1);
+    }
+    return _tolerated > _usedMemory ? _tolerated-_usedMemory : 0;
+  }
+  static void chargeExternalMemory(size_t size);
+  static void releaseExternalMemory(size_t size);
+
+  /**
+   * Parts of Vampire whose memory usage is counted separately. Memory is
+   * counted to the subsystem of the innermost SubsystemScope at the time
+   * of its allocation or deallocation.
+   */
+  enum class Subsystem : unsigned {
+    OTHER,
+    TERMS,
+    CLAUSES,
+    INDICES,
+    PASSIVE,
+    SAT_SOLVER,
+    INFERENCE_STORE
+  };
+  static const unsigned SUBSYSTEM_CNT = 7;
+
+  /** Makes the allocations during its lifetime count to a subsystem */
+  class SubsystemScope {
+  public:
+    explicit SubsystemScope(Subsystem s) : _save(_subsystem) { _subsystem = s; }
+    ~SubsystemScope() { _subsystem = _save; }
+  private:
+    Subsystem _save;
+  };
+
+  /**
+   * Return the number of bytes allocated and not yet deallocated within
+   * the subsystem @b s. Memory deallocated within another subsystem than
+   * the one it was allocated in moves from one counter to the other.
+   */
+  static long long getUsedMemory(Subsystem s)
+  { return _subsystemUsage[static_cast<unsigned>(s)]; }
+  static const char* subsystemName(Subsystem s);
+
+  /**
+   * Set the amount of used memory (in bytes) above which we are under
+   * memory pressure, 0 for no such limit
+   */
+  static void setMemoryPressureLimit(size_t size)
+  {
+    _memoryPressureLimit = size;
+    _underMemoryPressure = false;
+  }
+  /**
+   * True if the used memory grew over the memory pressure limit since
+   * it was last set. The allocator only records this, it is up to its
+   * users to check it when they can safely release memory.
+   */
+  static bool underMemoryPressure() { return _underMemoryPressure; }
+  static void forgetFreePieces();
   /** The current allocator
    * - through which allocations by the here defined macros are channelled */
   static Allocator* current;
@@ -312,6 +377,13 @@ private:
 
   /** Total memory allocated by pages */
   static size_t _usedMemory;
+  /** Memory used by each subsystem */
+  static long long _subsystemUsage[SUBSYSTEM_CNT];
+  /** The subsystem to which the memory is currently counted */
+  static Subsystem _subsystem;
+  /** Memory pressure limit, 0 if there is none */
+  static size_t _memoryPressureLimit;
+  static bool _underMemoryPressure;
   /** Page allocator array, a.k.a. "the global manager".
    * Each entry is a (singly linked) list */
   static Page* _pages[MAX_PAGES];
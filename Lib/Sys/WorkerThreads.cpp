@@ -0,0 +1,143 @@
+
+/*
+ * File WorkerThreads.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file WorkerThreads.cpp
+ * Implements class WorkerThreads.
+ */
+
+#include <atomic>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "Debug/Tracer.hpp"
+
+#include "Lib/DArray.hpp"
+#include "Lib/System.hpp"
+
+#include "WorkerThreads.hpp"
+
+namespace Lib
+{
+namespace Sys
+{
+
+namespace
+{
+
+struct SharedState
+{
+  WorkerThreads::Job* job;
+  unsigned taskCnt;
+  std::atomic<unsigned> nextTask;
+};
+
+struct WorkerArg
+{
+  SharedState* shared;
+  unsigned worker;
+};
+
+/**
+ * Take tasks from the shared counter until there are none left.
+ * Tasks are handed out dynamically as their sizes usually differ a lot.
+ */
+void doTasks(SharedState* shared, unsigned worker)
+{
+  for(;;) {
+    unsigned task = shared->nextTask.fetch_add(1);
+    if(task >= shared->taskCnt) {
+      return;
+    }
+    shared->job->run(task, worker);
+  }
+}
+
+void* workerMain(void* arg)
+{
+  WorkerArg* wa = static_cast<WorkerArg*>(arg);
+  doTasks(wa->shared, wa->worker);
+  return 0;
+}
+
+}
+
+/**
+ * Return the number of workers to use when @b requested were asked for,
+ * 0 meaning one per core.
+ */
+unsigned WorkerThreads::workerCount(unsigned requested)
+{
+  CALL("WorkerThreads::workerCount");
+
+  if(requested) {
+    return requested;
+  }
+  unsigned cores = System::getNumberOfCores();
+  return cores ? cores : 1;
+}
+
+/**
+ * Perform tasks 0,...,taskCnt-1 of @b job using at most @b workerCnt threads
+ * (including the calling one) and return once all of them are done.
+ */
+void WorkerThreads::run(Job& job, unsigned taskCnt, unsigned workerCnt)
+{
+  CALL("WorkerThreads::run");
+
+  SharedState shared;
+  shared.job = &job;
+  shared.taskCnt = taskCnt;
+  shared.nextTask = 0;
+
+  if(workerCnt > taskCnt) {
+    workerCnt = taskCnt;
+  }
+  if(workerCnt <= 1) {
+    doTasks(&shared, 0);
+    return;
+  }
+
+  DArray<pthread_t> threads(workerCnt);
+  DArray<WorkerArg> args(workerCnt);
+  DArray<bool> started(workerCnt);
+
+  // spawned threads inherit the signal mask, so block everything while creating them
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  for(unsigned i=1;i<workerCnt;i++) {
+    args[i].shared = &shared;
+    args[i].worker = i;
+    // if a thread cannot be created, the remaining workers simply do more tasks
+    started[i] = pthread_create(&threads[i], 0, workerMain, &args[i]) == 0;
+  }
+  pthread_sigmask(SIG_SETMASK, &old, 0);
+
+  doTasks(&shared, 0);
+
+  for(unsigned i=1;i<workerCnt;i++) {
+    if(started[i]) {
+      pthread_join(threads[i], 0);
+    }
+  }
+}
+
+}
+}
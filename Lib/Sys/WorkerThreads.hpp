@@ -0,0 +1,65 @@
+
+/*
+ * File WorkerThreads.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file WorkerThreads.hpp
+ * Defines class WorkerThreads.
+ */
+
+#ifndef __WorkerThreads__
+#define __WorkerThreads__
+
+#include "Forwards.hpp"
+
+namespace Lib {
+namespace Sys {
+
+/**
+ * Runs a fixed number of independent tasks on a few POSIX threads.
+ *
+ * Most of Vampire (the Allocator, the environment, term sharing) is not
+ * thread-safe, so the code executed by a Job must only read shared
+ * structures and must not allocate through the Allocator. Anything a task
+ * needs to write should be prepared by the calling thread beforehand and
+ * be private to the task (or to the worker executing it).
+ *
+ * Signals are blocked in the spawned threads, so timer interrupts are
+ * always delivered to the calling thread.
+ */
+class WorkerThreads
+{
+public:
+  class Job {
+  public:
+    virtual ~Job() {}
+    /**
+     * Perform task number @b task. @b worker is the index of the thread
+     * executing it (the calling thread is worker 0), which can be used
+     * to pick per-worker scratch data.
+     */
+    virtual void run(unsigned task, unsigned worker) = 0;
+  };
+
+  static void run(Job& job, unsigned taskCnt, unsigned workerCnt);
+  static unsigned workerCount(unsigned requested);
+};
+
+}
+}
+
+#endif // __WorkerThreads__
@@ -76,8 +76,33 @@ void SMTLIB2::parse(istream& str)
 
   LispLexer lex(str);
   LispParser lpar(lex);
-  LExpr* expr = lpar.parse();
-  parse(expr);
+
+  // read the benchmark one command at a time, so that the commands which
+  // were already processed need not be kept in memory
+  while (LExpr* lexp = lpar.parseNext()) {
+    CommandOutcome outcome = readCommand(lexp);
+    if (outcome != CommandOutcome::DEFINITION) {
+      lexp->destroy();
+    }
+
+    if (outcome == CommandOutcome::CHECK_SAT) {
+      LExpr* next = lpar.parseNext();
+      if (next) {
+        LispListReader exitRdr(next);
+        if (!exitRdr.tryAcceptAtom("exit")) {
+          warnCheckSatNotLast();
+        }
+        next->destroy();
+      }
+      break;
+    }
+    if (outcome == CommandOutcome::EXIT) {
+      if (LExpr* next = lpar.parseNext()) {
+        USER_ERROR("<eol> expected: "+next->toString());
+      }
+      break;
+    }
+  }
 }
 
 void SMTLIB2::parse(LExpr* bench)
@@ -95,200 +120,220 @@ void SMTLIB2::readBenchmark(LExprList* bench)
 
   // iteration over benchmark top level entries
   while(bRdr.hasNext()){
-    LExpr* lexp = bRdr.next();
+    CommandOutcome outcome = readCommand(bRdr.next());
 
-    LOG2("readBenchmark ",lexp->toString(true));
-
-    LispListReader ibRdr(lexp);
-
-    if (ibRdr.tryAcceptAtom("set-logic")) {
-      if (_logicSet) {
-        USER_ERROR("set-logic can appear only once in a problem");
+    if (outcome == CommandOutcome::CHECK_SAT) {
+      if (bRdr.hasNext()) {
+        LispListReader exitRdr(bRdr.readList());
+        if (!exitRdr.tryAcceptAtom("exit")) {
+          warnCheckSatNotLast();
+        }
       }
-      readLogic(ibRdr.readAtom());
-      ibRdr.acceptEOL();
-      continue;
+      break;
+    }
+    if (outcome == CommandOutcome::EXIT) {
+      bRdr.acceptEOL();
+      break;
     }
+  }
+}
 
-    if (ibRdr.tryAcceptAtom("set-info")) {
+void SMTLIB2::warnCheckSatNotLast()
+{
+  if(env.options->mode()!=Options::Mode::SPIDER) {
+    env.beginOutput();
+    env.out() << "% Warning: check-sat is not the last entry. Skipping the rest!" << endl;
+    env.endOutput();
+  }
+}
 
-      if (ibRdr.tryAcceptAtom(":status")) {
-        _statusStr = ibRdr.readAtom();
-        ibRdr.acceptEOL();
-        continue;
-      }
+/**
+ * Process a top level entry of a benchmark
+ */
+SMTLIB2::CommandOutcome SMTLIB2::readCommand(LExpr* lexp)
+{
+  CALL("SMTLIB2::readCommand");
 
-      if (ibRdr.tryAcceptAtom(":source")) {
-        _sourceInfo = ibRdr.readAtom();
-        ibRdr.acceptEOL();
-        continue;
-      }
+  LOG2("readCommand ",lexp->toString(true));
 
-      // ignore unknown info
-      ibRdr.readAtom();
-      ibRdr.readAtom();
-      ibRdr.acceptEOL();
-      continue;
+  LispListReader ibRdr(lexp);
+
+  if (ibRdr.tryAcceptAtom("set-logic")) {
+    if (_logicSet) {
+      USER_ERROR("set-logic can appear only once in a problem");
     }
+    readLogic(ibRdr.readAtom());
+    ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-    if (ibRdr.tryAcceptAtom("declare-sort")) {
-      vstring name = ibRdr.readAtom();
-      vstring arity;
-      if (!ibRdr.tryReadAtom(arity)) {
-        USER_ERROR("Unspecified arity while declaring sort: "+name);
-      }
+  if (ibRdr.tryAcceptAtom("set-info")) {
 
-      readDeclareSort(name,arity);
+    if (ibRdr.tryAcceptAtom(":status")) {
+      _statusStr = ibRdr.readAtom();
+      ibRdr.acceptEOL();
+      return CommandOutcome::CONTINUE;
+    }
 
+    if (ibRdr.tryAcceptAtom(":source")) {
+      _sourceInfo = ibRdr.readAtom();
       ibRdr.acceptEOL();
+      return CommandOutcome::CONTINUE;
+    }
 
-      continue;
+    // ignore unknown info
+    ibRdr.readAtom();
+    ibRdr.readAtom();
+    ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
+
+  if (ibRdr.tryAcceptAtom("declare-sort")) {
+    vstring name = ibRdr.readAtom();
+    vstring arity;
+    if (!ibRdr.tryReadAtom(arity)) {
+      USER_ERROR("Unspecified arity while declaring sort: "+name);
     }
 
-    if (ibRdr.tryAcceptAtom("define-sort")) {
-      vstring name = ibRdr.readAtom();
-      LExprList* args = ibRdr.readList();
-      LExpr* body = ibRdr.readNext();
+    readDeclareSort(name,arity);
 
-      readDefineSort(name,args,body);
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("define-sort")) {
+    vstring name = ibRdr.readAtom();
+    LExprList* args = ibRdr.readList();
+    LExpr* body = ibRdr.readNext();
 
-    if (ibRdr.tryAcceptAtom("declare-fun")) {
-      vstring name = ibRdr.readAtom();
-      LExprList* iSorts = ibRdr.readList();
-      LExpr* oSort = ibRdr.readNext();
+    readDefineSort(name,args,body);
 
-      readDeclareFun(name,iSorts,oSort);
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::DEFINITION;
+  }
 
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("declare-fun")) {
+    vstring name = ibRdr.readAtom();
+    LExprList* iSorts = ibRdr.readList();
+    LExpr* oSort = ibRdr.readNext();
 
-    if (ibRdr.tryAcceptAtom("declare-datatypes")) {
-      LExprList* sorts = ibRdr.readList();
-      LExprList* datatypes = ibRdr.readList();
+    readDeclareFun(name,iSorts,oSort);
 
-      readDeclareDatatypes(sorts, datatypes, false);
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("declare-datatypes")) {
+    LExprList* sorts = ibRdr.readList();
+    LExprList* datatypes = ibRdr.readList();
 
-    if (ibRdr.tryAcceptAtom("declare-codatatypes")) {
-      LExprList* sorts = ibRdr.readList();
-      LExprList* datatypes = ibRdr.readList();
+    readDeclareDatatypes(sorts, datatypes, false);
 
-      readDeclareDatatypes(sorts, datatypes, true);
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-      continue;
-    }
-    
-    if (ibRdr.tryAcceptAtom("declare-const")) {
-      vstring name = ibRdr.readAtom();
-      LExpr* oSort = ibRdr.readNext();
+  if (ibRdr.tryAcceptAtom("declare-codatatypes")) {
+    LExprList* sorts = ibRdr.readList();
+    LExprList* datatypes = ibRdr.readList();
 
-      readDeclareFun(name,nullptr,oSort);
+    readDeclareDatatypes(sorts, datatypes, true);
 
-      ibRdr.acceptEOL();
+    ibRdr.acceptEOL();
 
-      continue;
-    }
+    return CommandOutcome::CONTINUE;
+  }
+  
+  if (ibRdr.tryAcceptAtom("declare-const")) {
+    vstring name = ibRdr.readAtom();
+    LExpr* oSort = ibRdr.readNext();
 
-    if (ibRdr.tryAcceptAtom("define-fun")) {
-      vstring name = ibRdr.readAtom();
-      LExprList* iArgs = ibRdr.readList();
-      LExpr* oSort = ibRdr.readNext();
-      LExpr* body = ibRdr.readNext();
+    readDeclareFun(name,nullptr,oSort);
 
-      readDefineFun(name,iArgs,oSort,body);
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("define-fun")) {
+    vstring name = ibRdr.readAtom();
+    LExprList* iArgs = ibRdr.readList();
+    LExpr* oSort = ibRdr.readNext();
+    LExpr* body = ibRdr.readNext();
 
-    if (ibRdr.tryAcceptAtom("assert")) {
-      readAssert(ibRdr.readNext());
+    readDefineFun(name,iArgs,oSort,body);
 
-      ibRdr.acceptEOL();
+    ibRdr.acceptEOL();
 
-      continue;
-    }
+    return CommandOutcome::CONTINUE;
+  }
 
-    if (ibRdr.tryAcceptAtom("assert-not")) {
-      readAssertNot(ibRdr.readNext());
+  if (ibRdr.tryAcceptAtom("assert")) {
+    readAssert(ibRdr.readNext());
 
-      ibRdr.acceptEOL();
+    ibRdr.acceptEOL();
 
-      continue;
-    }
+    return CommandOutcome::CONTINUE;
+  }
 
-    // not an official SMTLIB command
-    if (ibRdr.tryAcceptAtom("color-symbol")) {
-      vstring symbol = ibRdr.readAtom();
+  if (ibRdr.tryAcceptAtom("assert-not")) {
+    readAssertNot(ibRdr.readNext());
 
-      if (ibRdr.tryAcceptAtom(":left")) {
-        colorSymbol(symbol, Color::COLOR_LEFT);
-      } else if (ibRdr.tryAcceptAtom(":right")) {
-        colorSymbol(symbol, Color::COLOR_RIGHT);
-      } else {
-        USER_ERROR("'"+ibRdr.readAtom()+"' is not a color keyword");
-      }
+    ibRdr.acceptEOL();
 
-      ibRdr.acceptEOL();
+    return CommandOutcome::CONTINUE;
+  }
 
-      continue;
-    }
+  // not an official SMTLIB command
+  if (ibRdr.tryAcceptAtom("color-symbol")) {
+    vstring symbol = ibRdr.readAtom();
 
-    if (ibRdr.tryAcceptAtom("check-sat")) {
-      if (bRdr.hasNext()) {
-        LispListReader exitRdr(bRdr.readList());
-        if (!exitRdr.tryAcceptAtom("exit")) {
-          if(env.options->mode()!=Options::Mode::SPIDER) {
-            env.beginOutput();
-            env.out() << "% Warning: check-sat is not the last entry. Skipping the rest!" << endl;
-            env.endOutput();
-          }
-        }
-      }
-      break;
+    if (ibRdr.tryAcceptAtom(":left")) {
+      colorSymbol(symbol, Color::COLOR_LEFT);
+    } else if (ibRdr.tryAcceptAtom(":right")) {
+      colorSymbol(symbol, Color::COLOR_RIGHT);
+    } else {
+      USER_ERROR("'"+ibRdr.readAtom()+"' is not a color keyword");
     }
 
-    if (ibRdr.tryAcceptAtom("exit")) {
-      bRdr.acceptEOL();
-      break;
-    }
+    ibRdr.acceptEOL();
 
-    if (ibRdr.tryAcceptAtom("reset")) {
-      LOG1("ignoring reset");
-      continue;
-    }
+    return CommandOutcome::CONTINUE;
+  }
 
-    if (ibRdr.tryAcceptAtom("set-option")) {
-      LOG2("ignoring set-option", ibRdr.readAtom());
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("check-sat")) {
+    return CommandOutcome::CHECK_SAT;
+  }
 
-    if (ibRdr.tryAcceptAtom("push")) {
-      LOG1("ignoring push");
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("exit")) {
+    return CommandOutcome::EXIT;
+  }
 
-    if (ibRdr.tryAcceptAtom("get-info")) {
-      LOG2("ignoring get-info", ibRdr.readAtom());
-      continue;
-    }
+  if (ibRdr.tryAcceptAtom("reset")) {
+    LOG1("ignoring reset");
+    return CommandOutcome::CONTINUE;
+  }
+
+  if (ibRdr.tryAcceptAtom("set-option")) {
+    LOG2("ignoring set-option", ibRdr.readAtom());
+    return CommandOutcome::CONTINUE;
+  }
 
-    USER_ERROR("unrecognized entry "+ibRdr.readAtom());
+  if (ibRdr.tryAcceptAtom("push")) {
+    LOG1("ignoring push");
+    return CommandOutcome::CONTINUE;
   }
+
+  if (ibRdr.tryAcceptAtom("get-info")) {
+    LOG2("ignoring get-info", ibRdr.readAtom());
+    return CommandOutcome::CONTINUE;
+  }
+
+  USER_ERROR("unrecognized entry "+ibRdr.readAtom());
 }
 
 //  ----------------------------------------------------------------------
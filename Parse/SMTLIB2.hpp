@@ -46,7 +46,7 @@ class SMTLIB2 {
 public:
   SMTLIB2(const Options& opts);
 
-  /** Parse from an open stream */
+  /** Parse from an open stream, one top level entry at a time */
   void parse(istream& str);
   /** Parse a ready lisp expression */
   void parse(LExpr* bench);
@@ -458,6 +458,24 @@ private:
    * Toplevel parsing dispatch for a benchmark.
    */
   void readBenchmark(LExprList* bench);
+
+  /** What the caller of readCommand should do next */
+  enum class CommandOutcome {
+    /** read the next command */
+    CONTINUE,
+    /** read the next command, but keep the expression of this one alive,
+     *  parts of it were stored (as by define-sort) */
+    DEFINITION,
+    /** stop reading, what follows should be (exit) */
+    CHECK_SAT,
+    /** stop reading, nothing should follow */
+    EXIT
+  };
+  /**
+   * Dispatch for a single toplevel entry of a benchmark.
+   */
+  CommandOutcome readCommand(LExpr* command);
+  void warnCheckSatNotLast();
 };
 
 }
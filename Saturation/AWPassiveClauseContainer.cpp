@@ -26,6 +26,7 @@
 
 #include "Debug/RuntimeStatistics.hpp"
 
+#include "Lib/DHMap.hpp"
 #include "Lib/Environment.hpp"
 #include "Lib/Int.hpp"
 #include "Lib/Timer.hpp"
@@ -51,6 +52,10 @@ using namespace Kernel;
 
 AWPassiveClauseContainer::AWPassiveClauseContainer(bool isOutermost, const Shell::Options& opt, vstring name) :
   PassiveClauseContainer(isOutermost, opt, name),
+  _useBuckets(isOutermost && opt.bucketPassiveQueue()),
+  _buckets(opt),
+  _useHistogram(isOutermost && opt.lrsHistogramLimits() &&
+      opt.saturationAlgorithm()==Options::SaturationAlgorithm::LRS),
   _ageQueue(opt),
   _weightQueue(opt),
   _ageRatio(opt.ageRatio()),
@@ -59,8 +64,6 @@ AWPassiveClauseContainer::AWPassiveClauseContainer(bool isOutermost, const Shell
   _size(0),
 
   _simulationBalance(0),
-  _simulationCurrAgeIt(_ageQueue),
-  _simulationCurrWeightIt(_weightQueue),
   _simulationCurrAgeCl(nullptr),
   _simulationCurrWeightCl(nullptr),
 
@@ -82,7 +85,7 @@ AWPassiveClauseContainer::AWPassiveClauseContainer(bool isOutermost, const Shell
 
 AWPassiveClauseContainer::~AWPassiveClauseContainer()
 {
-  ClauseQueue::Iterator cit(_ageQueue);
+  ClauseIterator cit = ageOrderIterator();
   while (cit.hasNext()) 
   {
     Clause* cl=cit.next();
@@ -91,6 +94,29 @@ AWPassiveClauseContainer::~AWPassiveClauseContainer()
   }
 }
 
+/**
+ * Iterator over passive clauses in the order of selection by weight
+ */
+ClauseIterator AWPassiveClauseContainer::weightOrderIterator()
+{
+  // like _weightQueue, the buckets are not there for selection by weight if _weightRatio=0
+  if (_useBuckets && _weightRatio) {
+    return pvi(ClauseBucketQueue::Iterator(_buckets, true));
+  }
+  return pvi(ClauseQueue::Iterator(_weightQueue));
+}
+
+/**
+ * Iterator over passive clauses in the order of selection by age
+ */
+ClauseIterator AWPassiveClauseContainer::ageOrderIterator()
+{
+  if (_useBuckets && _ageRatio) {
+    return pvi(ClauseBucketQueue::Iterator(_buckets, false));
+  }
+  return pvi(ClauseQueue::Iterator(_ageQueue));
+}
+
 /**
  * Weight comparison of clauses.
  * @return the result of comparison (LESS, EQUAL or GREATER)
@@ -186,13 +212,21 @@ void AWPassiveClauseContainer::add(Clause* cl)
   ASS(_ageRatio > 0 || _weightRatio > 0);
   ASS(cl->store() == Clause::PASSIVE);
 
-  if (_ageRatio) {
-    _ageQueue.insert(cl);
+  if (_useBuckets) {
+    _buckets.insert(cl);
   }
-  if (_weightRatio) {
-    _weightQueue.insert(cl);
+  else {
+    if (_ageRatio) {
+      _ageQueue.insert(cl);
+    }
+    if (_weightRatio) {
+      _weightQueue.insert(cl);
+    }
   }
   _size++;
+  if (_useHistogram) {
+    _histogram.add(cl->weightForClauseSelection(_opt), cl->age());
+  }
 
   if (_isOutermost)
   {
@@ -215,15 +249,23 @@ void AWPassiveClauseContainer::remove(Clause* cl)
   }
   ASS(_ageRatio > 0 || _weightRatio > 0);
   bool wasRemoved; // will be assigned, since at least one of the following checks succeeds
-  if (_ageRatio) {
-    wasRemoved = _ageQueue.remove(cl);
+  if (_useBuckets) {
+    wasRemoved = _buckets.remove(cl);
   }
-  if (_weightRatio) {
-    wasRemoved = _weightQueue.remove(cl);
+  else {
+    if (_ageRatio) {
+      wasRemoved = _ageQueue.remove(cl);
+    }
+    if (_weightRatio) {
+      wasRemoved = _weightQueue.remove(cl);
+    }
   }
 
   if (wasRemoved) {
     _size--;
+    if (_useHistogram) {
+      _histogram.remove(cl->weightForClauseSelection(_opt), cl->age());
+    }
   }
 
   if (_isOutermost)
@@ -294,12 +336,24 @@ Clause* AWPassiveClauseContainer::popSelected()
   Clause* cl;
   if (byWeight(_balance)) {
     _balance -= _ageRatio;
-    cl = _weightQueue.pop();
-    _ageQueue.remove(cl);
+    if (_useBuckets) {
+      cl = _buckets.popByWeight();
+    } else {
+      cl = _weightQueue.pop();
+      _ageQueue.remove(cl);
+    }
   } else {
     _balance += _weightRatio;
-    cl = _ageQueue.pop();
-    _weightQueue.remove(cl);
+    if (_useBuckets) {
+      cl = _buckets.popByAge();
+    } else {
+      cl = _ageQueue.pop();
+      _weightQueue.remove(cl);
+    }
+  }
+
+  if (_useHistogram) {
+    _histogram.remove(cl->weightForClauseSelection(_opt), cl->age());
   }
 
   if (_isOutermost) {
@@ -323,7 +377,7 @@ void AWPassiveClauseContainer::onLimitsUpdated()
   //(unless one of _ageRation or _weightRatio is equal to 0)
 
   static Stack<Clause*> toRemove(256);
-  ClauseQueue::Iterator wit(_weightQueue);
+  ClauseIterator wit = weightOrderIterator();
   while (wit.hasNext()) {
     Clause* cl=wit.next();
     if (!fulfilsAgeLimit(cl) && !fulfilsWeightLimit(cl)) {
@@ -353,8 +407,8 @@ void AWPassiveClauseContainer::simulationInit()
   _simulationBalance = _balance;
 
   // initialize iterators
-  _simulationCurrAgeIt = ClauseQueue::Iterator(_ageQueue);
-  _simulationCurrWeightIt = ClauseQueue::Iterator(_weightQueue);
+  _simulationCurrAgeIt = ageOrderIterator();
+  _simulationCurrWeightIt = weightOrderIterator();
   _simulationCurrAgeCl = _simulationCurrAgeIt.hasNext() ? _simulationCurrAgeIt.next() : nullptr;
   _simulationCurrWeightCl = _simulationCurrWeightIt.hasNext() ? _simulationCurrWeightIt.next() : nullptr;
 
@@ -508,6 +562,188 @@ bool AWPassiveClauseContainer::setLimitsFromSimulation()
   return setLimits(maxAgeQueueAge, maxAgeQueueWeight,maxWeightQueueWeight, maxWeightQueueAge);
 }
 
+void AWPassiveClauseContainer::updateLimits(long long estReachableCnt)
+{
+  CALL("AWPassiveClauseContainer::updateLimits");
+
+  // the histogram does not help if all clauses are going to be selected anyway,
+  // and the simulation handles queues not used for selection in its own way
+  if (!_useHistogram || !_ageRatio || !_weightRatio || estReachableCnt > static_cast<long long>(sizeEstimate())) {
+    PassiveClauseContainer::updateLimits(estReachableCnt);
+    return;
+  }
+
+#if VDEBUG
+  // check the histogram gives the limits the simulation would
+  unsigned ageSelectionMaxAge = _ageSelectionMaxAge;
+  unsigned ageSelectionMaxWeight = _ageSelectionMaxWeight;
+  unsigned weightSelectionMaxWeight = _weightSelectionMaxWeight;
+  unsigned weightSelectionMaxAge = _weightSelectionMaxAge;
+  bool simTightened = simulateSelection(estReachableCnt);
+  unsigned simAgeSelectionMaxAge = _ageSelectionMaxAge;
+  unsigned simAgeSelectionMaxWeight = _ageSelectionMaxWeight;
+  unsigned simWeightSelectionMaxWeight = _weightSelectionMaxWeight;
+  unsigned simWeightSelectionMaxAge = _weightSelectionMaxAge;
+  _ageSelectionMaxAge = ageSelectionMaxAge;
+  _ageSelectionMaxWeight = ageSelectionMaxWeight;
+  _weightSelectionMaxWeight = weightSelectionMaxWeight;
+  _weightSelectionMaxAge = weightSelectionMaxAge;
+#endif
+
+  bool tightened = setLimitsFromHistogram(estReachableCnt);
+
+  ASS_EQ(_ageSelectionMaxAge, simAgeSelectionMaxAge);
+  ASS_EQ(_ageSelectionMaxWeight, simAgeSelectionMaxWeight);
+  ASS_EQ(_weightSelectionMaxWeight, simWeightSelectionMaxWeight);
+  ASS_EQ(_weightSelectionMaxAge, simWeightSelectionMaxAge);
+  ASS_EQ(tightened, simTightened);
+
+  if (tightened) {
+    changedEvent.fire();
+  }
+}
+
+/**
+ * Set the limits to what setLimitsFromSimulation() would set after simulating
+ * the selection of @b estReachableCnt clauses, but without going through
+ * the clauses, only using _histogram.
+ *
+ * Clauses of the same weight and age are in the same order in both queues,
+ * so the ones taken from a cell during the simulation are always its first
+ * ones, no matter through which queue, and it is enough to count them.
+ * Moreover, as long as neither queue moves to another cell, the number of
+ * selections by weight among the next n ones follows from the balance and
+ * the ratio directly. The time needed therefore depends on the number of
+ * cells the simulation passes rather than on the number of clauses.
+ */
+bool AWPassiveClauseContainer::setLimitsFromHistogram(long long estReachableCnt)
+{
+  CALL("AWPassiveClauseContainer::setLimitsFromHistogram");
+  ASS_G(_ageRatio, 0);
+  ASS_G(_weightRatio, 0);
+
+  unsigned wqWeight = 0;
+  unsigned wqAge = 0;
+  unsigned aqWeight = 0;
+  unsigned aqAge = 0;
+  if (!_histogram.findByWeight(wqWeight, wqAge)) {
+    // passive is empty
+    return setLimitsToMax();
+  }
+  ALWAYS(_histogram.findByAge(aqWeight, aqAge));
+
+  // numbers of clauses taken from the cells during the simulation
+  static DHMap<pair<unsigned,unsigned>,unsigned> taken;
+  taken.reset();
+  auto takenFrom = [](unsigned weight, unsigned age) {
+    unsigned res = 0;
+    taken.find(make_pair(weight, age), res);
+    return res;
+  };
+  auto take = [](unsigned weight, unsigned age, long long cnt) {
+    unsigned* pCnt;
+    taken.getValuePtr(make_pair(weight, age), pCnt, 0);
+    *pCnt += cnt;
+  };
+
+  // When the balance is between lo and lo+period-1 (which it stays in once
+  // it gets there), the selection goes by weight iff balance-lo >= _ageRatio.
+  // With u = balance-lo, one selection turns u into (u+_weightRatio)%period
+  // and it is by weight iff the addition overflows, so after n selections,
+  // (u+n*_weightRatio)/period of them were by weight.
+  const long long ageRatio = _ageRatio;
+  const long long weightRatio = _weightRatio;
+  const long long period = ageRatio + weightRatio;
+  const long long lo = (_ageRatio <= _weightRatio) ? -ageRatio : 1-ageRatio;
+  long long balance = _balance;
+
+  long long remains = estReachableCnt;
+  bool exhausted = false;
+  for (;;) {
+    // move to the first clauses not taken yet, as simulationHasNext() does
+    while (_histogram.count(wqWeight, wqAge) == takenFrom(wqWeight, wqAge)) {
+      wqAge++;
+      if (!_histogram.findByWeight(wqWeight, wqAge)) {
+        exhausted = true;
+        break;
+      }
+    }
+    while (!exhausted && _histogram.count(aqWeight, aqAge) == takenFrom(aqWeight, aqAge)) {
+      aqWeight++;
+      if (!_histogram.findByAge(aqWeight, aqAge)) {
+        // both queues contain the same clauses
+        ASSERTION_VIOLATION;
+        exhausted = true;
+      }
+    }
+    if (exhausted || remains == 0) {
+      break;
+    }
+
+    if (balance < lo || balance >= lo+period) {
+      if (byWeight(balance)) {
+        balance -= ageRatio;
+        take(wqWeight, wqAge, 1);
+      } else {
+        balance += weightRatio;
+        take(aqWeight, aqAge, 1);
+      }
+      remains--;
+      continue;
+    }
+
+    long long u = balance - lo;
+    long long wqAvail = _histogram.count(wqWeight, wqAge) - takenFrom(wqWeight, wqAge);
+    long long aqAvail = _histogram.count(aqWeight, aqAge) - takenFrom(aqWeight, aqAge);
+    long long cnt = min(remains, wqAvail);
+    bool sameCell = wqWeight == aqWeight && wqAge == aqAge;
+    if (!sameCell) {
+      // the fewest selections after which wqAvail were by weight, or aqAvail by age
+      long long wqCnt = (wqAvail*period - u + weightRatio - 1) / weightRatio;
+      long long aqCnt = ((aqAvail-1)*period + u + ageRatio) / ageRatio;
+      cnt = min(remains, min(wqCnt, aqCnt));
+    }
+    ASS_G(cnt, 0);
+    long long byWeightCnt = (u + cnt*weightRatio) / period;
+    if (sameCell) {
+      take(wqWeight, wqAge, cnt);
+    } else {
+      take(wqWeight, wqAge, byWeightCnt);
+      take(aqWeight, aqAge, cnt - byWeightCnt);
+    }
+    balance = lo + (u + cnt*weightRatio) % period;
+    remains -= cnt;
+  }
+
+  unsigned maxAgeQueueAge = UINT_MAX;
+  unsigned maxAgeQueueWeight = UINT_MAX;
+  unsigned maxWeightQueueWeight = UINT_MAX;
+  unsigned maxWeightQueueAge = UINT_MAX;
+  if (!exhausted) {
+    // the limits are set as long as the simulation did not get to the last clause of the queue
+    unsigned nextWeight = aqWeight+1;
+    unsigned nextAge = aqAge;
+    if (_histogram.count(aqWeight, aqAge) - takenFrom(aqWeight, aqAge) > 1 || _histogram.findByAge(nextWeight, nextAge)) {
+      maxAgeQueueAge = aqAge;
+      maxAgeQueueWeight = aqWeight;
+    }
+    nextWeight = wqWeight;
+    nextAge = wqAge+1;
+    if (_histogram.count(wqWeight, wqAge) - takenFrom(wqWeight, wqAge) > 1 || _histogram.findByWeight(nextWeight, nextAge)) {
+      maxWeightQueueWeight = wqWeight;
+      maxWeightQueueAge = wqAge;
+    }
+  }
+
+  // as in setLimitsFromSimulation()
+  if (_opt.lrsWeightLimitOnly()) {
+    maxAgeQueueAge = 0;
+    maxAgeQueueWeight = 0;
+  }
+
+  return setLimits(maxAgeQueueAge, maxAgeQueueWeight, maxWeightQueueWeight, maxWeightQueueAge);
+} // AWPassiveClauseContainer::setLimitsFromHistogram
+
 bool AWPassiveClauseContainer::childrenPotentiallyFulfilLimits(Clause* cl, unsigned upperBoundNumSelLits) const
 {
   CALL("AWPassiveClauseContainer::childrenPotentiallyFulfilLimits");
@@ -629,6 +865,99 @@ bool AWPassiveClauseContainer::fulfilsWeightLimit(unsigned w, unsigned numPositi
   return weightForClauseSelection <= _weightSelectionMaxWeight || (weightForClauseSelection == _weightSelectionMaxWeight && age <= _weightSelectionMaxAge);
 }
 
+AgeWeightHistogram::~AgeWeightHistogram()
+{
+  CALL("AgeWeightHistogram::~AgeWeightHistogram");
+
+  for (unsigned w = 0; w < _rows.size(); w++) {
+    if (_rows[w]) {
+      delete _rows[w];
+    }
+  }
+  for (unsigned a = 0; a < _cols.size(); a++) {
+    if (_cols[a]) {
+      delete _cols[a];
+    }
+  }
+}
+
+/**
+ * Increase the count of the cell @b cellIdx of the line @b idx of @b lines
+ */
+void AgeWeightHistogram::add(DArray<Line*>& lines, unsigned idx, unsigned cellIdx)
+{
+  if (idx >= lines.size()) {
+    lines.expand(idx+1, nullptr);
+  }
+  Line* line = lines[idx];
+  if (!line) {
+    line = new Line();
+    lines[idx] = line;
+  }
+  if (cellIdx >= line->cells.size()) {
+    line->cells.expand(cellIdx+1, 0);
+  }
+  line->cells[cellIdx]++;
+  line->cnt++;
+}
+
+void AgeWeightHistogram::add(unsigned weight, unsigned age)
+{
+  CALL("AgeWeightHistogram::add");
+
+  add(_rows, weight, age);
+  add(_cols, age, weight);
+  _total++;
+}
+
+void AgeWeightHistogram::remove(unsigned weight, unsigned age)
+{
+  CALL("AgeWeightHistogram::remove");
+  ASS_G(count(weight, age), 0);
+
+  _rows[weight]->cells[age]--;
+  _rows[weight]->cnt--;
+  _cols[age]->cells[weight]--;
+  _cols[age]->cnt--;
+  _total--;
+}
+
+unsigned AgeWeightHistogram::count(unsigned weight, unsigned age) const
+{
+  if (weight >= _rows.size() || !_rows[weight] || age >= _rows[weight]->cells.size()) {
+    return 0;
+  }
+  return _rows[weight]->cells[age];
+}
+
+/**
+ * Move @b idx and @b cellIdx to the first non-empty cell of @b lines which
+ * is not before them in the order by line and then by cell, and return true,
+ * or return false if there is no such cell
+ *
+ * With the rows, this goes through the cells in the weight order, with the
+ * columns in the age order.
+ */
+bool AgeWeightHistogram::find(const DArray<Line*>& lines, unsigned& idx, unsigned& cellIdx)
+{
+  CALL("AgeWeightHistogram::find");
+
+  for (unsigned i = idx, c = cellIdx; i < lines.size(); i++, c = 0) {
+    const Line* line = lines[i];
+    if (!line || !line->cnt) {
+      continue;
+    }
+    for (; c < line->cells.size(); c++) {
+      if (line->cells[c]) {
+        idx = i;
+        cellIdx = c;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 AWClauseContainer::AWClauseContainer(const Options& opt)
 : _ageQueue(opt), _weightQueue(opt), _ageRatio(1), _weightRatio(1), _balance(0), _size(0)
 {
@@ -28,7 +28,9 @@
 #include <memory>
 #include <vector>
 #include "Lib/Comparison.hpp"
+#include "Lib/DArray.hpp"
 #include "Kernel/Clause.hpp"
+#include "Kernel/ClauseBucketQueue.hpp"
 #include "Kernel/ClauseQueue.hpp"
 #include "ClauseContainer.hpp"
 
@@ -66,6 +68,61 @@ private:
   const Shell::Options& _opt;
 };
 
+/**
+ * Numbers of passive clauses of each weight for clause selection and age
+ *
+ * Cells are visited in the weight order (by weight, then by age) or in
+ * the age order (by age, then by weight), skipping the empty ones.
+ * The counts are kept both by rows of one weight and by columns of one
+ * age, so that either order only goes through the cells of the lines
+ * it visits.
+ */
+class AgeWeightHistogram
+{
+public:
+  CLASS_NAME(AgeWeightHistogram);
+  USE_ALLOCATOR(AgeWeightHistogram);
+
+  AgeWeightHistogram() : _total(0) {}
+  ~AgeWeightHistogram();
+
+  void add(unsigned weight, unsigned age);
+  void remove(unsigned weight, unsigned age);
+
+  unsigned count(unsigned weight, unsigned age) const;
+  /** The number of clauses in all the cells */
+  unsigned total() const { return _total; }
+
+  bool findByWeight(unsigned& weight, unsigned& age) const
+  { return find(_rows, weight, age); }
+  bool findByAge(unsigned& weight, unsigned& age) const
+  { return find(_cols, age, weight); }
+
+private:
+  /** Cells of one weight or of one age */
+  struct Line
+  {
+    CLASS_NAME(AgeWeightHistogram::Line);
+    USE_ALLOCATOR(AgeWeightHistogram::Line);
+
+    Line() : cnt(0) {}
+
+    /** counts indexed by age in a row and by weight in a column */
+    DArray<unsigned> cells;
+    /** number of clauses in the line */
+    unsigned cnt;
+  };
+
+  static void add(DArray<Line*>& lines, unsigned idx, unsigned cellIdx);
+  static bool find(const DArray<Line*>& lines, unsigned& idx, unsigned& cellIdx);
+
+  /** rows indexed by weight, 0 for weights never used */
+  DArray<Line*> _rows;
+  /** columns indexed by age, 0 for ages never used */
+  DArray<Line*> _cols;
+  unsigned _total;
+};
+
 /**
  * Defines the class Passive of passive clauses
  * @since 31/12/2007 Manchester
@@ -88,13 +145,26 @@ public:
   Clause* popSelected() override;
   /** True if there are no passive clauses */
   bool isEmpty() const override
-  { return _ageQueue.isEmpty() && _weightQueue.isEmpty(); }
+  { return _useBuckets ? _buckets.isEmpty() : (_ageQueue.isEmpty() && _weightQueue.isEmpty()); }
 
   unsigned sizeEstimate() const override { return _size; }
 
   static Comparison compareWeight(Clause* cl1, Clause* cl2, const Shell::Options& opt);
 
 private:
+  ClauseIterator weightOrderIterator();
+  ClauseIterator ageOrderIterator();
+
+  /**
+   * If true, clauses are kept in _buckets and the two queues are not used.
+   * Only for the outermost container, as a clause can be in one bucket queue only.
+   */
+  bool _useBuckets;
+  /** Both queues in one, used if _useBuckets */
+  ClauseBucketQueue _buckets;
+  /** If true, _histogram is maintained and used to compute the LRS limits */
+  bool _useHistogram;
+  AgeWeightHistogram _histogram;
   /** The age queue, empty if _ageRatio=0 */
   AgeQueue _ageQueue;
   /** The weight queue, empty if _weightRatio=0 */
@@ -122,13 +192,16 @@ public:
   // returns whether at least one of the limits was tightened
   bool setLimitsFromSimulation() override;
 
+  void updateLimits(long long estReachableCnt) override;
+
   void onLimitsUpdated() override;
 private:
+  bool setLimitsFromHistogram(long long estReachableCnt);
   bool setLimits(unsigned newAgeSelectionMaxAge, unsigned newAgeSelectionMaxWeight, unsigned newWeightSelectionMaxWeight, unsigned newWeightSelectionMaxAge);
 
   int _simulationBalance;
-  ClauseQueue::Iterator _simulationCurrAgeIt;
-  ClauseQueue::Iterator _simulationCurrWeightIt;
+  ClauseIterator _simulationCurrAgeIt;
+  ClauseIterator _simulationCurrWeightIt;
   Clause* _simulationCurrAgeCl;
   Clause* _simulationCurrWeightCl;
 
@@ -145,20 +145,7 @@ void PassiveClauseContainer::updateLimits(long long estReachableCnt)
   // otherwise we run the simulation and set the limits accordingly
   else
   {
-    Clause::requestAux();
-
-    simulationInit();
-
-    long long remains=estReachableCnt;
-    while (simulationHasNext() && remains > 0)
-    {
-      simulationPopSelected();
-      remains--;
-    }
-
-    atLeastOneLimitTightened = setLimitsFromSimulation();
-
-    Clause::releaseAux();
+    atLeastOneLimitTightened = simulateSelection(estReachableCnt);
   }
 
   if (atLeastOneLimitTightened) {
@@ -167,6 +154,31 @@ void PassiveClauseContainer::updateLimits(long long estReachableCnt)
   }
 }
 
+/**
+ * Simulate the selection of @b estReachableCnt clauses and set the limits
+ * accordingly. Return true if at least one of the limits was tightened.
+ */
+bool PassiveClauseContainer::simulateSelection(long long estReachableCnt)
+{
+  CALL("PassiveClauseContainer::simulateSelection");
+
+  Clause::requestAux();
+
+  simulationInit();
+
+  long long remains=estReachableCnt;
+  while (simulationHasNext() && remains > 0)
+  {
+    simulationPopSelected();
+    remains--;
+  }
+
+  bool atLeastOneLimitTightened = setLimitsFromSimulation();
+
+  Clause::releaseAux();
+  return atLeastOneLimitTightened;
+}
+
 /////////////////   ActiveClauseContainer   //////////////////////
 
 void ActiveClauseContainer::add(Clause* c)
@@ -145,7 +145,7 @@ public:
   /*
    * LRS specific methods for computation of Limits
    */
-  void updateLimits(long long estReachableCnt);
+  virtual void updateLimits(long long estReachableCnt);
 
   virtual void simulationInit() = 0;
   virtual bool simulationHasNext() = 0;
@@ -179,6 +179,8 @@ public:
   virtual bool childrenPotentiallyFulfilLimits(Clause* cl, unsigned upperBoundNumSelLits) const = 0;
 
 protected:
+  bool simulateSelection(long long estReachableCnt);
+
   bool _isOutermost;
   const Shell::Options& _opt;
 
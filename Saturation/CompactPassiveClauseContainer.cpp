@@ -0,0 +1,394 @@
+
+/*
+ * File CompactPassiveClauseContainer.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file CompactPassiveClauseContainer.cpp
+ * Implements the class CompactPassiveClauseContainer
+ */
+
+#include "Debug/RuntimeStatistics.hpp"
+
+#include "Lib/Int.hpp"
+
+#include "Shell/Options.hpp"
+
+#include "CompactPassiveClauseContainer.hpp"
+
+namespace Saturation
+{
+using namespace Lib;
+using namespace Kernel;
+
+const unsigned CompactPassiveClauseContainer::RECORD_CHUNK_SIZE;
+const unsigned CompactPassiveClauseContainer::LITERAL_CHUNK_SIZE;
+
+CompactPassiveClauseContainer::Record::Record(Clause* cl, unsigned weight)
+: clause(cl), number(cl->number()), weight(weight),
+  litOffset(0), length(cl->length()), live(1), inferenceArchived(0), inference(cl->inference())
+{
+}
+
+Comparison CompactPassiveClauseContainer::QueueEntryComparator::compare(const QueueEntry& e1, const QueueEntry& e2)
+{
+  if (e1.key1 != e2.key1) {
+    return Int::compare(e1.key1, e2.key1);
+  }
+  if (e1.key2 != e2.key2) {
+    return Int::compare(e1.key2, e2.key2);
+  }
+  return Int::compare(e1.record, e2.record);
+}
+
+CompactPassiveClauseContainer::CompactPassiveClauseContainer(bool isOutermost, const Shell::Options& opt)
+: PassiveClauseContainer(isOutermost, opt),
+  _ageRatio(opt.ageRatio()),
+  _weightRatio(opt.weightRatio()),
+  _balance(0),
+  _recordCnt(0),
+  _literalCnt(0),
+  _liveCnt(0)
+{
+  CALL("CompactPassiveClauseContainer::CompactPassiveClauseContainer");
+
+  ASS_GE(_ageRatio, 0);
+  ASS_GE(_weightRatio, 0);
+  ASS(_ageRatio > 0 || _weightRatio > 0);
+}
+
+CompactPassiveClauseContainer::~CompactPassiveClauseContainer()
+{
+  CALL("CompactPassiveClauseContainer::~CompactPassiveClauseContainer");
+
+  for (unsigned i = 0; i < _recordCnt; i++) {
+    Record& r = record(i);
+    if (r.live) {
+      if (r.clause) {
+        ASS(!_isOutermost || r.clause->store()==Clause::PASSIVE);
+        r.clause->setStore(Clause::NONE);
+        r.clause->decRefCnt();
+      }
+      else {
+        // release the premises the way the deleted clause would have
+        r.inference.destroy();
+      }
+    }
+    r.~Record();
+  }
+  while (_recordChunks.isNonEmpty()) {
+    DEALLOC_KNOWN(_recordChunks.pop(), RECORD_CHUNK_SIZE*sizeof(Record), "CompactPassiveClauseContainer::Record");
+  }
+  while (_literalChunks.isNonEmpty()) {
+    DEALLOC_KNOWN(_literalChunks.pop(), LITERAL_CHUNK_SIZE*sizeof(Literal*), "CompactPassiveClauseContainer::literals");
+  }
+}
+
+/**
+ * Append @b r to the records and return its index
+ */
+unsigned CompactPassiveClauseContainer::pushRecord(const Record& r)
+{
+  CALL("CompactPassiveClauseContainer::pushRecord");
+
+  if (_recordCnt == _recordChunks.size()*RECORD_CHUNK_SIZE) {
+    void* mem = ALLOC_KNOWN(RECORD_CHUNK_SIZE*sizeof(Record), "CompactPassiveClauseContainer::Record");
+    _recordChunks.push(static_cast<Record*>(mem));
+  }
+  unsigned idx = _recordCnt++;
+  new (&record(idx)) Record(r);
+  return idx;
+}
+
+/**
+ * Return the position for @b length literals that are to be stored
+ * after the first @b offset positions of the literal chunks. The literals
+ * of a clause are kept in one chunk, so the rest of a chunk is skipped
+ * when they do not fit in it. Chunks are allocated as they are needed.
+ */
+unsigned CompactPassiveClauseContainer::literalOffset(unsigned offset, unsigned length)
+{
+  CALL("CompactPassiveClauseContainer::literalOffset");
+  ASS_LE(length, LITERAL_CHUNK_SIZE);
+
+  if (offset%LITERAL_CHUNK_SIZE + length > LITERAL_CHUNK_SIZE) {
+    offset += LITERAL_CHUNK_SIZE - offset%LITERAL_CHUNK_SIZE;
+  }
+  while (offset + length > _literalChunks.size()*LITERAL_CHUNK_SIZE) {
+    void* mem = ALLOC_KNOWN(LITERAL_CHUNK_SIZE*sizeof(Literal*), "CompactPassiveClauseContainer::literals");
+    _literalChunks.push(static_cast<Literal**>(mem));
+  }
+  return offset;
+}
+
+/**
+ * Add @b cl to the container, which keeps a reference to it. The clause
+ * is compacted later, when whoever added it has had the chance to drop
+ * its references to it.
+ */
+void CompactPassiveClauseContainer::add(Clause* cl)
+{
+  CALL("CompactPassiveClauseContainer::add");
+  ASS(cl->store() == Clause::PASSIVE);
+
+  compactPending();
+
+  cl->incRefCnt();
+
+  unsigned idx = pushRecord(Record(cl, cl->weightForClauseSelection(_opt)));
+  _uncompacted.insert(cl, idx);
+  _pending.push(idx);
+  enqueue(idx);
+  _liveCnt++;
+
+  if (_isOutermost) {
+    addedEvent.fire(cl);
+  }
+}
+
+/**
+ * Remove @b cl from the container. Only clauses which were not compacted
+ * can be removed, but no one else knows about the compacted ones.
+ */
+void CompactPassiveClauseContainer::remove(Clause* cl)
+{
+  CALL("CompactPassiveClauseContainer::remove");
+  if (_isOutermost) {
+    ASS(cl->store()==Clause::PASSIVE);
+  }
+
+  unsigned idx;
+  bool found = _uncompacted.pop(cl, idx);
+  if (found) {
+    kill(idx);
+  }
+
+  if (_isOutermost) {
+    removedEvent.fire(cl);
+    ASS(cl->store()!=Clause::PASSIVE);
+  }
+  if (found) {
+    // at this point the cl object can be deleted
+    cl->decRefCnt();
+  }
+}
+
+bool CompactPassiveClauseContainer::byWeight() const
+{
+  if (!_ageRatio) {
+    return true;
+  }
+  if (!_weightRatio) {
+    return false;
+  }
+  if (_balance != 0) {
+    return _balance > 0;
+  }
+  return _ageRatio <= _weightRatio;
+}
+
+Clause* CompactPassiveClauseContainer::popSelected()
+{
+  CALL("CompactPassiveClauseContainer::popSelected");
+  ASS(!isEmpty());
+
+  compactPending();
+  if (_recordCnt > RECORD_CHUNK_SIZE && _liveCnt < _recordCnt/2) {
+    collectGarbage();
+  }
+
+  bool weight = byWeight();
+  if (weight) {
+    _balance -= _ageRatio;
+  } else {
+    _balance += _weightRatio;
+  }
+  Queue& queue = weight ? _weightQueue : _ageQueue;
+  // entries of records selected through the other queue are skipped here
+  while (!record(queue.top().record).live) {
+    queue.pop();
+  }
+  unsigned idx = queue.pop().record;
+
+  Clause* cl = materialize(idx);
+  kill(idx);
+
+  if (_isOutermost) {
+    selectedEvent.fire(cl);
+  }
+  return cl;
+}
+
+/**
+ * Compact clauses of the records added since the last call
+ * that are not referred to from anywhere else, i.e. whose only
+ * reference is the one of the container
+ */
+void CompactPassiveClauseContainer::compactPending()
+{
+  CALL("CompactPassiveClauseContainer::compactPending");
+
+  // in the order of addition, so that the literals are in the order of records
+  for (unsigned i = 0; i < _pending.size(); i++) {
+    unsigned idx = _pending[i];
+    Record& r = record(idx);
+    if (!r.live) {
+      continue;
+    }
+    Clause* cl = r.clause;
+    ASS(cl);
+    // a reference besides the one of the container means someone else may still look at the object
+    if (cl->refCnt() > 1 || cl->store()!=Clause::PASSIVE ||
+        r.length > LITERAL_CHUNK_SIZE) {
+      continue;
+    }
+    compactRecord(idx);
+  }
+  _pending.reset();
+}
+
+void CompactPassiveClauseContainer::compactRecord(unsigned idx)
+{
+  CALL("CompactPassiveClauseContainer::compactRecord");
+
+  Record& r = record(idx);
+  Clause* cl = r.clause;
+
+  r.litOffset = literalOffset(_literalCnt, r.length);
+  _literalCnt = r.litOffset + r.length;
+  Literal** lits = literals(r.litOffset);
+  for (unsigned i = 0; i < r.length; i++) {
+    lits[i] = (*cl)[i];
+  }
+  // the record takes over the inference together with the references to premises
+  r.inference = cl->inference();
+  r.inferenceArchived = cl->inferenceArchived();
+  r.clause = 0;
+  ALWAYS(_uncompacted.remove(cl));
+  cl->destroyExceptInferenceObject();
+  RSTAT_CTR_INC("passive clauses compacted");
+}
+
+/**
+ * Return the clause of the record @b idx, building it if it was compacted.
+ * The container does not keep a reference to the returned clause.
+ */
+Clause* CompactPassiveClauseContainer::materialize(unsigned idx)
+{
+  CALL("CompactPassiveClauseContainer::materialize");
+
+  Record& r = record(idx);
+  if (r.clause) {
+    Clause* cl = r.clause;
+    ALWAYS(_uncompacted.remove(cl));
+    // the clause is still in passive, so this does not delete it
+    cl->decRefCnt();
+    return cl;
+  }
+  Clause* cl = Clause::restore(r.number, r.length, literals(r.litOffset), r.inference);
+  cl->setStore(Clause::PASSIVE);
+  if (r.inferenceArchived) {
+    // so that the arena does not record the clause again
+    cl->markInferenceArchived();
+  }
+  return cl;
+}
+
+/**
+ * Mark record @b idx as no longer in the container. Its queue entries
+ * are skipped when they get to the top.
+ */
+void CompactPassiveClauseContainer::kill(unsigned idx)
+{
+  Record& r = record(idx);
+  ASS(r.live);
+  r.live = 0;
+  r.clause = 0;
+  _liveCnt--;
+}
+
+void CompactPassiveClauseContainer::enqueue(unsigned idx)
+{
+  const Record& r = record(idx);
+  if (_weightRatio) {
+    QueueEntry e = { r.weight, r.age(), idx };
+    _weightQueue.insert(e);
+  }
+  if (_ageRatio) {
+    QueueEntry e = { r.age(), r.weight, idx };
+    _ageQueue.insert(e);
+  }
+}
+
+/**
+ * Drop the records that are no longer live and rebuild the queues
+ *
+ * Must be called only when there are no pending records.
+ */
+void CompactPassiveClauseContainer::collectGarbage()
+{
+  CALL("CompactPassiveClauseContainer::collectGarbage");
+  ASS(_pending.isEmpty());
+
+  // records keep their relative order, and so do the literals of compacted
+  // ones, which therefore never move to a later position
+  unsigned newCnt = 0;
+  unsigned newLitCnt = 0;
+  for (unsigned i = 0; i < _recordCnt; i++) {
+    Record& old = record(i);
+    if (!old.live) {
+      old.~Record();
+      continue;
+    }
+    if (newCnt != i) {
+      new (&record(newCnt)) Record(old);
+      old.~Record();
+    }
+    Record& r = record(newCnt);
+    if (r.clause) {
+      _uncompacted.set(r.clause, newCnt);
+    }
+    else {
+      unsigned offset = literalOffset(newLitCnt, r.length);
+      ASS_LE(offset, r.litOffset);
+      Literal** from = literals(r.litOffset);
+      Literal** to = literals(offset);
+      for (unsigned j = 0; j < r.length; j++) {
+        to[j] = from[j];
+      }
+      r.litOffset = offset;
+      newLitCnt = offset + r.length;
+    }
+    newCnt++;
+  }
+  ASS_EQ(newCnt, _liveCnt);
+  _recordCnt = newCnt;
+  _literalCnt = newLitCnt;
+  while (_recordChunks.size()*RECORD_CHUNK_SIZE >= _recordCnt+RECORD_CHUNK_SIZE) {
+    DEALLOC_KNOWN(_recordChunks.pop(), RECORD_CHUNK_SIZE*sizeof(Record), "CompactPassiveClauseContainer::Record");
+  }
+  while (_literalChunks.size()*LITERAL_CHUNK_SIZE >= _literalCnt+LITERAL_CHUNK_SIZE) {
+    DEALLOC_KNOWN(_literalChunks.pop(), LITERAL_CHUNK_SIZE*sizeof(Literal*), "CompactPassiveClauseContainer::literals");
+  }
+
+  _weightQueue.reset();
+  _ageQueue.reset();
+  for (unsigned i = 0; i < newCnt; i++) {
+    enqueue(i);
+  }
+}
+
+}
@@ -0,0 +1,186 @@
+
+/*
+ * File CompactPassiveClauseContainer.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file CompactPassiveClauseContainer.hpp
+ * Defines the class CompactPassiveClauseContainer
+ */
+
+#ifndef __CompactPassiveClauseContainer__
+#define __CompactPassiveClauseContainer__
+
+#include "Lib/BinaryHeap.hpp"
+#include "Lib/Comparison.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/Inference.hpp"
+
+#include "ClauseContainer.hpp"
+
+namespace Saturation {
+
+using namespace Kernel;
+
+/**
+ * Passive container that keeps the waiting clauses in a compact form
+ * instead of as Clause objects.
+ *
+ * A clause added to the container is turned into a record holding its
+ * number, selection weight and age and its inference, while its literals
+ * go to buffers shared by all records. The Clause object itself is then
+ * deleted and a new one with the same number, literals and inference is
+ * only built when the record is selected.
+ *
+ * The container holds a reference to each clause it keeps as an object,
+ * and only compacts a clause when that reference is its only one, which
+ * for a clause from preprocessing needs the problem to have given up its
+ * reference (see history_gc). Otherwise the clause stays as it is.
+ * The caller has to drop its own references for clauses to be compacted,
+ * which SaturationAlgorithm does for the Discount loop without AVATAR,
+ * the only one where passive clauses are not used for simplification.
+ * Clauses are selected by age and weight in a constant ratio as in
+ * AWPassiveClauseContainer; clauses of equal weight and age are taken
+ * in the order in which they were added. LRS limits are not supported.
+ */
+class CompactPassiveClauseContainer
+: public PassiveClauseContainer
+{
+public:
+  CLASS_NAME(CompactPassiveClauseContainer);
+  USE_ALLOCATOR(CompactPassiveClauseContainer);
+
+  CompactPassiveClauseContainer(bool isOutermost, const Shell::Options& opt);
+  ~CompactPassiveClauseContainer();
+
+  void add(Clause* cl) override;
+  void remove(Clause* cl) override;
+  Clause* popSelected() override;
+
+  bool isEmpty() const override { return _liveCnt==0; }
+  unsigned sizeEstimate() const override { return _liveCnt; }
+
+private:
+  struct Record
+  {
+    Record(Clause* cl, unsigned weight);
+
+    unsigned age() const { return inference.age(); }
+
+    /** the clause if it was not compacted, otherwise 0 */
+    Clause* clause;
+    unsigned number;
+    unsigned weight;
+    /** position of the literals in the literal chunks */
+    unsigned litOffset;
+    unsigned length : 30;
+    /** false once the record was selected or removed */
+    unsigned live : 1;
+    /** true if the inference of the compacted clause is in an InferenceArena */
+    unsigned inferenceArchived : 1;
+    /**
+     * inference of the clause; for a compacted clause the record owns it
+     * and the references to the premises that come with it
+     */
+    Inference inference;
+  };
+
+  /** Entry of a selection queue: the record with its keys */
+  struct QueueEntry
+  {
+    unsigned key1;
+    unsigned key2;
+    unsigned record;
+  };
+  struct QueueEntryComparator
+  {
+    static Comparison compare(const QueueEntry& e1, const QueueEntry& e2);
+  };
+  typedef BinaryHeap<QueueEntry,QueueEntryComparator> Queue;
+
+  /**
+   * Records and literals are kept in chunks of a fixed size rather than in
+   * stacks, as the allocator keeps the memory of the smaller arrays a stack
+   * leaves behind when it grows for arrays of the same size only.
+   */
+  static const unsigned RECORD_CHUNK_SIZE = 4096;
+  static const unsigned LITERAL_CHUNK_SIZE = 65536;
+
+  Record& record(unsigned idx)
+  { return _recordChunks[idx/RECORD_CHUNK_SIZE][idx%RECORD_CHUNK_SIZE]; }
+  Literal** literals(unsigned offset)
+  { return _literalChunks[offset/LITERAL_CHUNK_SIZE]+offset%LITERAL_CHUNK_SIZE; }
+  unsigned pushRecord(const Record& r);
+  unsigned literalOffset(unsigned offset, unsigned length);
+
+  bool byWeight() const;
+  void compactPending();
+  void compactRecord(unsigned idx);
+  Clause* materialize(unsigned idx);
+  void kill(unsigned idx);
+  void enqueue(unsigned idx);
+  void collectGarbage();
+
+  int _ageRatio;
+  int _weightRatio;
+  /** If &lt;0 then selection by age, if &gt;0 then by weight */
+  int _balance;
+
+  Stack<Record*> _recordChunks;
+  unsigned _recordCnt;
+  /** literals of the compacted records */
+  Stack<Literal**> _literalChunks;
+  /** number of positions used in the literal chunks */
+  unsigned _literalCnt;
+  /** records added since the last compaction */
+  Stack<unsigned> _pending;
+  /** records whose clauses were not compacted */
+  DHMap<Clause*,unsigned> _uncompacted;
+  Queue _weightQueue;
+  Queue _ageQueue;
+
+  unsigned _liveCnt;
+
+  /*
+   * LRS is not supported, so the limits are never set
+   */
+public:
+  void simulationInit() override {}
+  bool simulationHasNext() override { return false; }
+  void simulationPopSelected() override {}
+
+  bool setLimitsToMax() override { return false; }
+  bool setLimitsFromSimulation() override { return false; }
+
+  void onLimitsUpdated() override {}
+
+  bool ageLimited() const override { return false; }
+  bool weightLimited() const override { return false; }
+
+  bool fulfilsAgeLimit(Clause* c) const override { return true; }
+  bool fulfilsAgeLimit(unsigned w, unsigned numPositiveLiterals, const Inference& inference) const override { return true; }
+  bool fulfilsWeightLimit(Clause* cl) const override { return true; }
+  bool fulfilsWeightLimit(unsigned w, unsigned numPositiveLiterals, const Inference& inference) const override { return true; }
+
+  bool childrenPotentiallyFulfilLimits(Clause* cl, unsigned upperBoundNumSelLits) const override { return true; }
+}; // class CompactPassiveClauseContainer
+
+}
+
+#endif /* __CompactPassiveClauseContainer__ */
@@ -0,0 +1,364 @@
+
+/*
+ * File LearnedPassiveClauseContainer.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file LearnedPassiveClauseContainer.cpp
+ * Implements the class LearnedPassiveClauseContainer
+ */
+
+#include <fstream>
+
+#include "Lib/Environment.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/SharedSet.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Term.hpp"
+
+#include "Shell/Options.hpp"
+
+#include "LearnedPassiveClauseContainer.hpp"
+
+namespace Saturation
+{
+using namespace std;
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * Create the model scoring clauses by their weight
+ */
+ClauseScoringModel::ClauseScoringModel()
+: _bias(0)
+{
+  for (unsigned i = 0; i < FEATURE_CNT; i++) {
+    _coefs[i] = 0;
+  }
+  _coefs[WEIGHT] = 1;
+}
+
+bool ClauseScoringModel::featureByName(const vstring& name, unsigned& feature)
+{
+  static const char* names[FEATURE_CNT] = {
+    "weight", "age", "length", "positive", "equalities", "variables",
+    "symbols", "goal", "sine_level", "theory", "splits"
+  };
+  for (unsigned i = 0; i < FEATURE_CNT; i++) {
+    if (name == names[i]) {
+      feature = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Load the coefficients from the file @b fileName
+ *
+ * Each line of the file consists of a feature name and its coefficient,
+ * the name "bias" standing for the absolute term. Empty lines and lines
+ * starting with # are ignored. Features that are not mentioned get
+ * the coefficient 0.
+ */
+void ClauseScoringModel::load(const vstring& fileName)
+{
+  CALL("ClauseScoringModel::load");
+
+  _bias = 0;
+  _coefs[WEIGHT] = 0;
+
+  BYPASSING_ALLOCATOR;
+
+  ifstream file(fileName.c_str());
+  if (!file.is_open()) {
+    USER_ERROR("Cannot open the clause selection model file " + fileName);
+  }
+  vstring line;
+  unsigned lineNum = 0;
+  while (getline(file, line)) {
+    lineNum++;
+    vistringstream lineStr(line);
+    vstring name;
+    vstring value;
+    if (!(lineStr >> name) || name[0] == '#') {
+      continue;
+    }
+    float coef;
+    vstring rest;
+    if (!(lineStr >> value) || !Int::stringToFloat(value.c_str(), coef) || (lineStr >> rest)) {
+      USER_ERROR("Line " + Int::toString(lineNum) + " of " + fileName + " is not a feature name followed by a number");
+    }
+    unsigned feature;
+    if (name == "bias") {
+      _bias = coef;
+    }
+    else if (featureByName(name, feature)) {
+      _coefs[feature] = coef;
+    }
+    else {
+      USER_ERROR("Unknown feature " + name + " in " + fileName);
+    }
+  }
+}
+
+/**
+ * Store FEATURE_CNT features of @b cl to @b features
+ *
+ * All the features are cheap, so they can be computed for every passive
+ * clause. The SInE level is 255 for clauses not derived from axioms that
+ * were given one.
+ */
+void ClauseScoringModel::computeFeatures(Clause* cl, float* features)
+{
+  CALL("ClauseScoringModel::computeFeatures");
+
+  unsigned equalities = 0;
+  unsigned varOccs = 0;
+  unsigned symbols = 0;
+  for (unsigned i = 0; i < cl->length(); i++) {
+    Literal* lit = (*cl)[i];
+    if (lit->isEquality()) {
+      equalities++;
+    }
+    varOccs += lit->vars();
+    symbols += lit->weight() - lit->vars();
+  }
+
+  const Inference& inf = cl->inference();
+  features[WEIGHT] = cl->weight();
+  features[AGE] = cl->age();
+  features[LENGTH] = cl->length();
+  features[POSITIVE] = cl->numPositiveLiterals();
+  features[EQUALITIES] = equalities;
+  features[VARIABLES] = varOccs;
+  features[SYMBOLS] = symbols;
+  features[GOAL] = inf.derivedFromGoal() ? 1 : 0;
+  features[SINE_LEVEL] = inf.getSineLevel();
+  features[THEORY] = inf.isPureTheoryDescendant() ? 1 : 0;
+  features[SPLITS] = cl->splits() ? cl->splits()->size() : 0;
+}
+
+/**
+ * Score @b cnt clauses whose features are stored one after another
+ * in @b features and store the results to @b scores
+ */
+void ClauseScoringModel::score(const float* features, unsigned cnt, float* scores) const
+{
+  CALL("ClauseScoringModel::score");
+
+  // the loops have no dependencies between iterations and get vectorized
+  for (unsigned i = 0; i < cnt; i++) {
+    scores[i] = _bias;
+  }
+  for (unsigned f = 0; f < FEATURE_CNT; f++) {
+    float coef = _coefs[f];
+    if (coef == 0) {
+      continue;
+    }
+    for (unsigned i = 0; i < cnt; i++) {
+      scores[i] += coef * features[i*FEATURE_CNT + f];
+    }
+  }
+}
+
+const unsigned LearnedPassiveClauseContainer::BATCH_SIZE;
+
+Comparison LearnedPassiveClauseContainer::ScoredClauseComparator::compare(const ScoredClause& sc1, const ScoredClause& sc2)
+{
+  if (sc1.score != sc2.score) {
+    return sc1.score < sc2.score ? LESS : GREATER;
+  }
+  if (sc1.cl->age() != sc2.cl->age()) {
+    return Int::compare(sc1.cl->age(), sc2.cl->age());
+  }
+  return Int::compare(sc1.cl->number(), sc2.cl->number());
+}
+
+LearnedPassiveClauseContainer::LearnedPassiveClauseContainer(bool isOutermost, const Shell::Options& opt)
+: PassiveClauseContainer(isOutermost, opt),
+  _ageQueue(opt),
+  _ageRatio(opt.ageRatio()),
+  _weightRatio(opt.weightRatio()),
+  _balance(0),
+  _size(0)
+{
+  CALL("LearnedPassiveClauseContainer::LearnedPassiveClauseContainer");
+
+  ASS_GE(_ageRatio, 0);
+  ASS_GE(_weightRatio, 0);
+  ASS(_ageRatio > 0 || _weightRatio > 0);
+
+  _model.load(opt.clauseSelectionModel());
+}
+
+void LearnedPassiveClauseContainer::add(Clause* cl)
+{
+  CALL("LearnedPassiveClauseContainer::add");
+  ASS(cl->store() == Clause::PASSIVE);
+
+  if (_ageRatio) {
+    _ageQueue.insert(cl);
+  }
+  if (_weightRatio) {
+    if (_pending.size() == BATCH_SIZE) {
+      scorePending();
+    }
+    ClauseScoringModel::computeFeatures(cl, _pendingFeatures + _pending.size()*ClauseScoringModel::FEATURE_CNT);
+    _pending.push(cl);
+  }
+  _size++;
+
+  if (_isOutermost) {
+    addedEvent.fire(cl);
+  }
+}
+
+void LearnedPassiveClauseContainer::remove(Clause* cl)
+{
+  CALL("LearnedPassiveClauseContainer::remove");
+  if (_isOutermost) {
+    ASS(cl->store()==Clause::PASSIVE);
+  }
+
+  bool wasRemoved = false;
+  if (_ageRatio) {
+    wasRemoved = _ageQueue.remove(cl);
+  }
+  if (_weightRatio) {
+    wasRemoved = removeScored(cl) || removePending(cl);
+  }
+  if (wasRemoved) {
+    _size--;
+  }
+
+  if (_isOutermost) {
+    removedEvent.fire(cl);
+    ASS(cl->store()!=Clause::PASSIVE);
+  }
+}
+
+/**
+ * Remove @b cl from the clauses waiting to be scored, return true
+ * if it was there
+ */
+bool LearnedPassiveClauseContainer::removePending(Clause* cl)
+{
+  CALL("LearnedPassiveClauseContainer::removePending");
+
+  const unsigned fcnt = ClauseScoringModel::FEATURE_CNT;
+  for (unsigned i = 0; i < _pending.size(); i++) {
+    if (_pending[i] != cl) {
+      continue;
+    }
+    // keep the order, so that the scores do not depend on removals
+    unsigned last = _pending.size() - 1;
+    for (unsigned j = i; j < last; j++) {
+      _pending[j] = _pending[j+1];
+    }
+    for (unsigned k = i*fcnt; k < last*fcnt; k++) {
+      _pendingFeatures[k] = _pendingFeatures[k+fcnt];
+    }
+    _pending.pop();
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Remove @b cl from the score queue, return true if it was there
+ */
+bool LearnedPassiveClauseContainer::removeScored(Clause* cl)
+{
+  CALL("LearnedPassiveClauseContainer::removeScored");
+
+  // the queue needs the score of the clause to find it
+  ScoredClause sc;
+  sc.cl = cl;
+  if (!_scores.pop(cl, sc.score)) {
+    return false;
+  }
+  _scoreQueue.remove(sc);
+  return true;
+}
+
+/**
+ * Score the clauses waiting to be scored and move them to the score queue
+ */
+void LearnedPassiveClauseContainer::scorePending()
+{
+  CALL("LearnedPassiveClauseContainer::scorePending");
+
+  static float scores[BATCH_SIZE];
+
+  unsigned cnt = _pending.size();
+  ASS_LE(cnt, BATCH_SIZE);
+  _model.score(_pendingFeatures, cnt, scores);
+  for (unsigned i = 0; i < cnt; i++) {
+    ScoredClause sc;
+    sc.score = scores[i];
+    sc.cl = _pending[i];
+    ALWAYS(_scores.insert(sc.cl, sc.score));
+    _scoreQueue.insert(sc);
+  }
+  _pending.reset();
+}
+
+bool LearnedPassiveClauseContainer::byScore() const
+{
+  if (!_ageRatio) {
+    return true;
+  }
+  if (!_weightRatio) {
+    return false;
+  }
+  if (_balance != 0) {
+    return _balance > 0;
+  }
+  return _ageRatio <= _weightRatio;
+}
+
+Clause* LearnedPassiveClauseContainer::popSelected()
+{
+  CALL("LearnedPassiveClauseContainer::popSelected");
+  ASS(!isEmpty());
+
+  _size--;
+
+  Clause* cl;
+  if (byScore()) {
+    _balance -= _ageRatio;
+    scorePending();
+    cl = _scoreQueue.pop().cl;
+    ALWAYS(_scores.remove(cl));
+    _ageQueue.remove(cl);
+  }
+  else {
+    _balance += _weightRatio;
+    cl = _ageQueue.pop();
+    if (_weightRatio && !removeScored(cl)) {
+      ALWAYS(removePending(cl));
+    }
+  }
+
+  if (_isOutermost) {
+    selectedEvent.fire(cl);
+  }
+  return cl;
+}
+
+}
@@ -0,0 +1,165 @@
+
+/*
+ * File LearnedPassiveClauseContainer.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file LearnedPassiveClauseContainer.hpp
+ * Defines the class LearnedPassiveClauseContainer
+ */
+
+#ifndef __LearnedPassiveClauseContainer__
+#define __LearnedPassiveClauseContainer__
+
+#include "Lib/Comparison.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/SkipList.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/Clause.hpp"
+
+#include "AWPassiveClauseContainer.hpp"
+#include "ClauseContainer.hpp"
+
+namespace Saturation {
+
+using namespace Kernel;
+
+/**
+ * Linear model scoring clauses by their features, the lower the score
+ * the sooner the clause should be selected
+ */
+class ClauseScoringModel
+{
+public:
+  /** Features of a clause, in the order in which they are stored */
+  enum Feature {
+    WEIGHT,
+    AGE,
+    LENGTH,
+    POSITIVE,
+    EQUALITIES,
+    VARIABLES,
+    SYMBOLS,
+    GOAL,
+    SINE_LEVEL,
+    THEORY,
+    SPLITS,
+    FEATURE_CNT
+  };
+
+  ClauseScoringModel();
+
+  void load(const vstring& fileName);
+  static void computeFeatures(Clause* cl, float* features);
+  void score(const float* features, unsigned cnt, float* scores) const;
+
+private:
+  static bool featureByName(const vstring& name, unsigned& feature);
+
+  float _bias;
+  float _coefs[FEATURE_CNT];
+};
+
+/**
+ * Passive container selecting clauses by the score of a ClauseScoringModel
+ * and by age in the age to weight ratio, the score taking the place
+ * of the weight.
+ *
+ * Features of a clause are computed when it is added, while the scores are
+ * computed for a batch of clauses at once, when a clause is to be selected
+ * by the score or when the batch is full. Clauses of the same score are
+ * selected by age and number. LRS limits are not supported.
+ */
+class LearnedPassiveClauseContainer
+: public PassiveClauseContainer
+{
+public:
+  CLASS_NAME(LearnedPassiveClauseContainer);
+  USE_ALLOCATOR(LearnedPassiveClauseContainer);
+
+  LearnedPassiveClauseContainer(bool isOutermost, const Shell::Options& opt);
+
+  void add(Clause* cl) override;
+  void remove(Clause* cl) override;
+  Clause* popSelected() override;
+
+  bool isEmpty() const override { return _size==0; }
+  unsigned sizeEstimate() const override { return _size; }
+
+private:
+  /** A clause in the score queue together with its score */
+  struct ScoredClause
+  {
+    float score;
+    Clause* cl;
+  };
+  struct ScoredClauseComparator
+  {
+    static Comparison compare(const ScoredClause& sc1, const ScoredClause& sc2);
+  };
+
+  static const unsigned BATCH_SIZE = 64;
+
+  bool byScore() const;
+  void scorePending();
+  bool removeScored(Clause* cl);
+  bool removePending(Clause* cl);
+
+  ClauseScoringModel _model;
+  /** The age queue, empty if _ageRatio=0 */
+  AgeQueue _ageQueue;
+  /** Clauses that were already scored */
+  SkipList<ScoredClause,ScoredClauseComparator> _scoreQueue;
+  /** Scores of the clauses in _scoreQueue, needed to find them there */
+  DHMap<Clause*,float> _scores;
+  /** Clauses waiting to be scored */
+  Stack<Clause*> _pending;
+  /** Features of _pending, FEATURE_CNT values per clause */
+  float _pendingFeatures[BATCH_SIZE*ClauseScoringModel::FEATURE_CNT];
+  int _ageRatio;
+  int _weightRatio;
+  /** If &lt;0 then selection by age, if &gt;0 by score */
+  int _balance;
+  unsigned _size;
+
+  /*
+   * LRS is not supported, so the limits are never set
+   */
+public:
+  void simulationInit() override {}
+  bool simulationHasNext() override { return false; }
+  void simulationPopSelected() override {}
+
+  bool setLimitsToMax() override { return false; }
+  bool setLimitsFromSimulation() override { return false; }
+
+  void onLimitsUpdated() override {}
+
+  bool ageLimited() const override { return false; }
+  bool weightLimited() const override { return false; }
+
+  bool fulfilsAgeLimit(Clause* c) const override { return true; }
+  bool fulfilsAgeLimit(unsigned w, unsigned numPositiveLiterals, const Inference& inference) const override { return true; }
+  bool fulfilsWeightLimit(Clause* cl) const override { return true; }
+  bool fulfilsWeightLimit(unsigned w, unsigned numPositiveLiterals, const Inference& inference) const override { return true; }
+
+  bool childrenPotentiallyFulfilLimits(Clause* cl, unsigned upperBoundNumSelLits) const override { return true; }
+}; // class LearnedPassiveClauseContainer
+
+}
+
+#endif /* __LearnedPassiveClauseContainer__ */
@@ -40,6 +40,7 @@
 #include "Kernel/EqHelper.hpp"
 #include "Kernel/FormulaUnit.hpp"
 #include "Kernel/Inference.hpp"
+#include "Kernel/InferenceArena.hpp"
 #include "Kernel/InferenceStore.hpp"
 #include "Kernel/KBO.hpp"
 #include "Kernel/LiteralSelector.hpp"
@@ -97,6 +98,8 @@
 #include "SaturationAlgorithm.hpp"
 #include "ManCSPassiveClauseContainer.hpp"
 #include "AWPassiveClauseContainer.hpp"
+#include "CompactPassiveClauseContainer.hpp"
+#include "LearnedPassiveClauseContainer.hpp"
 #include "PredicateSplitPassiveClauseContainer.hpp"
 #include "Discount.hpp"
 #include "LRS.hpp"
@@ -206,15 +209,21 @@ std::unique_ptr<PassiveClauseContainer> makeLevel4(bool isOutermost, const Optio
  */
 SaturationAlgorithm::SaturationAlgorithm(Problem& prb, const Options& opt)
   : MainLoop(prb, opt),
+    _passiveShrunk(false),
     _clauseActivationInProgress(false),
     _fwSimplifiers(0), _bwSimplifiers(0), _splitter(0),
     _consFinder(0), _labelFinder(0), _symEl(0), _answerLiteralManager(0),
+    _inferenceArena(0),
     _instantiation(0),
 #if VZ3
     _theoryInstSimp(0),
 #endif
     _generatedClauseCount(0),
-    _activationLimit(0)
+    _activationLimit(0),
+    _stepCnt(0),
+    _stepRunStarted(false),
+    _stepRunFinished(false),
+    _stepRunResult(Statistics::UNKNOWN)
 {
   CALL("SaturationAlgorithm::SaturationAlgorithm");
   ASS_EQ(s_instance, 0);  //there can be only one saturation algorithm at a time
@@ -230,18 +239,34 @@ SaturationAlgorithm::SaturationAlgorithm(Problem& prb, const Options& opt)
 
   _completeOptionSettings = opt.complete(prb);
 
+  if (opt.memoryPressureThreshold()) {
+    Allocator::setMemoryPressureLimit(Allocator::getMemoryLimit()/100*opt.memoryPressureThreshold());
+  }
+
   _unprocessed = new UnprocessedClauseContainer();
 
   if (opt.useManualClauseSelection())
   {
     _passive = Lib::make_unique<ManCSPassiveClauseContainer>(true, opt);
   }
+  else if (opt.compactPassive())
+  {
+    _passive = Lib::make_unique<CompactPassiveClauseContainer>(true, opt);
+  }
+  else if (!opt.clauseSelectionModel().empty())
+  {
+    _passive = Lib::make_unique<LearnedPassiveClauseContainer>(true, opt);
+  }
   else
   {
     _passive = makeLevel4(true, opt, "");
   }
   _active = new ActiveClauseContainer(opt);
 
+  if (opt.proofHistory() != Options::ProofHistory::CLAUSES) {
+    _inferenceArena = new InferenceArena(opt.proofHistory() == Options::ProofHistory::SPILL);
+  }
+
   _active->attach(this);
   _passive->attach(this);
 
@@ -273,6 +298,7 @@ SaturationAlgorithm::~SaturationAlgorithm()
   ASS_EQ(s_instance,this);
 
   s_instance=0;
+  Allocator::setMemoryPressureLimit(0);
 
   if (_splitter) {
     delete _splitter;
@@ -283,6 +309,9 @@ SaturationAlgorithm::~SaturationAlgorithm()
   if (_symEl) {
     delete _symEl;
   }
+  if (_inferenceArena) {
+    delete _inferenceArena;
+  }
 
   _active->detach();
   _passive->detach();
@@ -329,7 +358,38 @@ void SaturationAlgorithm::tryUpdateFinalClauseCount()
  */
 bool SaturationAlgorithm::isComplete()
 {
-  return _completeOptionSettings && !env.statistics->inferencesSkippedDueToColors;
+  return _completeOptionSettings && !_passiveShrunk && !env.statistics->inferencesSkippedDueToColors;
+}
+
+/**
+ * Called between algorithm steps when the used memory got over the memory
+ * pressure limit
+ *
+ * The passive limits are tightened so that about a half of passive clauses
+ * remain reachable, which discards the others as well as the new clauses
+ * not fulfilling the limits. The next reaction comes when a half of the
+ * remaining memory is used.
+ */
+void SaturationAlgorithm::onMemoryPressure()
+{
+  CALL("SaturationAlgorithm::onMemoryPressure");
+
+  size_t used = Allocator::getUsedMemory();
+  size_t limit = Allocator::getMemoryLimit();
+  Allocator::setMemoryPressureLimit(used < limit ? used + (limit-used)/2 : limit);
+
+  unsigned passiveCnt = _passive->sizeEstimate();
+  if (passiveCnt < 2) {
+    return;
+  }
+  env.statistics->memoryPressureReactions++;
+  {
+    TimeCounter tc(TC_PASSIVE_CONTAINER_MAINTENANCE);
+    _passive->updateLimits(passiveCnt/2);
+  }
+  if (_passive->weightLimited() || _passive->ageLimited()) {
+    _passiveShrunk = true;
+  }
 }
 
 ClauseIterator SaturationAlgorithm::activeClauses()
@@ -622,12 +682,22 @@ int SaturationAlgorithm::elapsedTime()
  * The clause @b cl is added into the unprocessed container, unless the
  * set-of-support option is enabled and @b cl has input type equal to
  * @b Clause::AXIOM. In this case, @b cl is put into the active container.
+ *
+ * Besides the clauses of the problem, which are added by init(), further
+ * clauses may be added between two calls of runSteps(). If the run ended
+ * by saturating the clauses, the new clause lets the next call resume it.
  */
 void SaturationAlgorithm::addInputClause(Clause* cl)
 {
   CALL("SaturationAlgorithm::addInputClause");
   ASS_LE(toNumber(cl->inputType()),toNumber(UnitInputType::CLAIM)); // larger input types should not appear in proof search
 
+  if (_stepRunFinished && _passive->isEmpty() &&
+      (_stepRunResult.terminationReason == Statistics::SATISFIABLE ||
+       _stepRunResult.terminationReason == Statistics::REFUTATION_NOT_FOUND)) {
+    _stepRunFinished = false;
+  }
+
   if (_symEl) {
     _symEl->onInputClause(cl);
   }
@@ -748,6 +818,14 @@ void SaturationAlgorithm::init()
     addInputClause(cl);
   }
 
+  if (_opt.historyGC()) {
+    // From now on the input clauses are only referred to by the containers and
+    // by their descendants, which keep reference counts, so the problem can hand
+    // them over and they are freed like any other clause. Those already deleted
+    // go right away.
+    _prb.releaseClauses();
+  }
+
   if (_splitter) {
     _splitter->init(this);
   }
@@ -819,6 +897,11 @@ void SaturationAlgorithm::newClausesToUnprocessed()
   while (_newClauses.isNonEmpty()) {
     Clause* cl=_newClauses.popWithoutDec();
 
+    if (_inferenceArena) {
+      // the premises of cl are no longer needed once recorded in the arena
+      _inferenceArena->archive(cl);
+    }
+
     switch(cl->store())
     {
     case Clause::UNPROCESSED:
@@ -907,6 +990,10 @@ void SaturationAlgorithm::handleEmptyClause(Clause* cl)
       throw MainLoop::MainLoopFinishedException(Statistics::REFUTATION_NOT_FOUND);
     }
 
+    if (_inferenceArena) {
+      cl = _inferenceArena->reconstruct(cl);
+    }
+
     //TODO - warning, derivedFromInput potentially inefficient
     if(!cl->derivedFromInput()){
       ASSERTION_VIOLATION_REP("The proof does not contain any input clauses.");
@@ -1050,7 +1137,12 @@ void SaturationAlgorithm::removeActiveOrPassiveClause(Clause* cl)
   switch(cl->store()) {
   case Clause::PASSIVE:
   {
+    if (_opt.compactPassive()) {
+      // see addToPassive
+      cl->incRefCnt();
+    }
     TimeCounter tc(TC_PASSIVE_CONTAINER_MAINTENANCE);
+    Allocator::SubsystemScope scope(Allocator::Subsystem::PASSIVE);
     _passive->remove(cl);
     break;
   }
@@ -1076,8 +1168,15 @@ void SaturationAlgorithm::addToPassive(Clause* cl)
 
   {
     TimeCounter tc(TC_PASSIVE_CONTAINER_MAINTENANCE);
+    Allocator::SubsystemScope scope(Allocator::Subsystem::PASSIVE);
     _passive->add(cl);
   }
+  if (_opt.compactPassive()) {
+    // the container keeps its own reference and can only compact clauses
+    // referenced by nothing else, so it is given the one forwardSimplify took,
+    // which is taken again when the clause leaves passive
+    cl->decRefCnt();
+  }
 }
 
 /**
@@ -1289,8 +1388,13 @@ void SaturationAlgorithm::doOneAlgorithmStep()
   Clause* cl = nullptr;
   {
     TimeCounter tc(TC_PASSIVE_CONTAINER_MAINTENANCE);
+    Allocator::SubsystemScope scope(Allocator::Subsystem::PASSIVE);
     cl = _passive->popSelected();
   }
+  if (_opt.compactPassive()) {
+    // see addToPassive
+    cl->incRefCnt();
+  }
   ASS_EQ(cl->store(),Clause::PASSIVE);
   cl->setStore(Clause::SELECTED);
 
@@ -1305,6 +1409,31 @@ void SaturationAlgorithm::doOneAlgorithmStep()
 }
 
 
+/**
+ * Perform one step of the saturation, checking the activation,
+ * memory and time limits
+ */
+void SaturationAlgorithm::doLimitedAlgorithmStep()
+{
+  CALL("SaturationAlgorithm::doLimitedAlgorithmStep");
+
+  if (_activationLimit && _stepCnt > _activationLimit) {
+    throw ActivationLimitExceededException();
+  }
+
+  doOneAlgorithmStep();
+  _stepCnt++;
+
+  if (Allocator::underMemoryPressure()) {
+    onMemoryPressure();
+  }
+
+  Timer::syncClock();
+  if (env.timeLimitReached()) {
+    throw TimeLimitExceededException();
+  }
+}
+
 /**
  * Perform saturation on clauses that were added through
  * @b addInputClauses function
@@ -1313,20 +1442,10 @@ MainLoopResult SaturationAlgorithm::runImpl()
 {
   CALL("SaturationAlgorithm::runImpl");
 
-  unsigned l = 0;
   try
   {
-    for (;;l++) {
-      if (_activationLimit && l > _activationLimit) {
-        throw ActivationLimitExceededException();
-      }
-
-      doOneAlgorithmStep();
-
-      Timer::syncClock();
-      if (env.timeLimitReached()) {
-        throw TimeLimitExceededException();
-      }
+    for (;;) {
+      doLimitedAlgorithmStep();
     }
   }
   catch(ThrowableBase&)
@@ -1337,6 +1456,43 @@ MainLoopResult SaturationAlgorithm::runImpl()
 
 }
 
+/**
+ * Run at most @b stepLimit steps of the saturation instead of the
+ * @c MainLoop::run() function. The first call loads the input clauses,
+ * the following ones resume where the previous one stopped.
+ *
+ * If the saturation did not terminate within the budget, the result has
+ * the termination reason UNKNOWN and another call may follow. The
+ * statistics in @c env.statistics describe the run so far. Once a call
+ * terminates the run, the following ones return the same result without
+ * doing any steps, unless addInputClause() reopened a saturated run.
+ */
+MainLoopResult SaturationAlgorithm::runSteps(unsigned stepLimit)
+{
+  CALL("SaturationAlgorithm::runSteps");
+
+  if (_stepRunFinished) {
+    return _stepRunResult;
+  }
+  try {
+    if (!_stepRunStarted) {
+      _stepRunStarted = true;
+      init();
+    }
+    for (unsigned i = 0; i < stepLimit; i++) {
+      doLimitedAlgorithmStep();
+    }
+  }
+  catch(...) {
+    tryUpdateFinalClauseCount();
+    _stepRunResult = terminationResult();
+    _stepRunFinished = true;
+    return _stepRunResult;
+  }
+  tryUpdateFinalClauseCount();
+  return MainLoopResult(Statistics::UNKNOWN);
+}
+
 #if VZ3
 void SaturationAlgorithm::setTheoryInstAndSimp(TheoryInstAndSimp* t)
 {
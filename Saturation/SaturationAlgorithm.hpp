@@ -72,6 +72,9 @@ public:
   void initAlgorithmRun();
   void doOneAlgorithmStep();
 
+  MainLoopResult runSteps(unsigned stepLimit);
+  void addInputClause(Clause* cl);
+
   UnitList* collectSaturatedSet();
 
   void setGeneratingInferenceEngine(GeneratingInferenceEngine* generator);
@@ -132,6 +135,7 @@ public:
 protected:
   virtual void init();
   virtual MainLoopResult runImpl();
+  void doLimitedAlgorithmStep();
   void doUnprocessedLoop();
   virtual void handleUnsuccessfulActivation(Clause* c);
   virtual bool handleClauseBeforeActivation(Clause* c);
@@ -156,11 +160,11 @@ protected:
   void onAllProcessed();
   int elapsedTime();
   virtual bool isComplete();
+  virtual void onMemoryPressure();
 
 private:
   void passiveRemovedHandler(Clause* cl);
   void activeRemovedHandler(Clause* cl);
-  void addInputClause(Clause* cl);
 
   LiteralSelector& getSosLiteralSelector();
 
@@ -176,6 +180,8 @@ private:
 protected:
 
   bool _completeOptionSettings;
+  /** true if passive clauses were discarded because of memory pressure */
+  bool _passiveShrunk;
   int _startTime;
   bool _clauseActivationInProgress;
 
@@ -206,6 +212,8 @@ protected:
   LabelFinder* _labelFinder;
   SymElOutput* _symEl;
   AnswerLiteralManager* _answerLiteralManager;
+  /** if non-zero, new clauses archive their inferences here */
+  InferenceArena* _inferenceArena;
   Instantiation* _instantiation;
 #if VZ3
   TheoryInstAndSimp* _theoryInstSimp;
@@ -230,6 +238,13 @@ protected:
   unsigned _generatedClauseCount;
 
   unsigned _activationLimit;
+  /** number of steps done by runImpl or runSteps */
+  unsigned _stepCnt;
+  /** true once runSteps initialized the algorithm */
+  bool _stepRunStarted;
+  /** true if a call of runSteps ended the run, with the result _stepRunResult */
+  bool _stepRunFinished;
+  MainLoopResult _stepRunResult;
 private:
   static ImmediateSimplificationEngine* createISE(Problem& prb, const Options& opt, Ordering& ordering);
 };
@@ -142,6 +142,7 @@ void SplittingBranchSelector::updateVarCnt()
   _trueInCCModel.expand(satVarCnt+1);
 
   // solver may be doing the same, but only internally
+  Allocator::SubsystemScope scope(Allocator::Subsystem::SAT_SOLVER);
   _solver->ensureVarCount(satVarCnt);
 }
 
@@ -580,6 +581,7 @@ void SplittingBranchSelector::addSatClauseToSolver(SATClause* cl, bool branchRef
 
   RSTAT_CTR_INC("ssat_sat_clauses");
 
+  Allocator::SubsystemScope scope(Allocator::Subsystem::SAT_SOLVER);
   if (branchRefutation && _minSCO) {
     _solver->addClauseIgnoredInPartialModel(cl);
   } else {
@@ -598,6 +600,7 @@ void SplittingBranchSelector::recomputeModel(SplitLevelStack& addedComps, SplitL
   SATSolver::Status stat;
   {
     TimeCounter tc1(TC_SAT_SOLVER);
+    Allocator::SubsystemScope scope(Allocator::Subsystem::SAT_SOLVER);
     if (randomize) {
       _solver->randomizeForNextAssignment(maxSatVar);
     }
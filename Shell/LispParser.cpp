@@ -113,6 +113,10 @@ void LispParser::parse(List** expr0)
   static Stack<List**> stack;
   stack.reset();
 
+  // parsing of a list whose left parenthesis was already read by parseNext()
+  // ends with its right parenthesis
+  int startBalance = _balance;
+
   stack.push(expr0);
 
   Token t;
@@ -128,6 +132,9 @@ void LispParser::parse(List** expr0)
           throw Exception("unmatched right parenthesis",t);
         }
         _balance--;
+        if (_balance < startBalance) {
+          return;
+        }
         goto parsing_level_done;
       case TT_LPAR:
         _balance++;
@@ -170,6 +177,61 @@ void LispParser::parse(List** expr0)
 
 } // parse()
 
+/**
+ * Parse the next top-level expression and return it, or return 0
+ * if there are no more expressions. Unlike parse(), this allows to
+ * process a large input one expression at a time.
+ */
+LispParser::Expression* LispParser::parseNext()
+{
+  CALL("LispParser::parseNext");
+  ASS_EQ(_balance, 0);
+
+  Token t;
+  _lexer.readToken(t);
+  switch (t.tag) {
+  case TT_LPAR:
+    {
+      _balance++;
+      Expression* result = new Expression(LIST);
+      parse(&result->list);
+      ASS_EQ(_balance, 0);
+      return result;
+    }
+  case TT_NAME:
+  case TT_INTEGER:
+  case TT_REAL:
+    return new Expression(ATOM,t.text);
+  case TT_RPAR:
+    throw Exception("unmatched right parenthesis",t);
+  case TT_EOF:
+    return 0;
+  default:
+    ASSERTION_VIOLATION;
+    return 0;
+  }
+} // parseNext()
+
+/**
+ * Delete this expression together with all its subexpressions
+ */
+void LispParser::Expression::destroy()
+{
+  CALL("LispParser::Expression::destroy");
+
+  // deeply nested expressions are common, so no recursion here
+  static Stack<Expression*> todo;
+  todo.reset();
+  todo.push(this);
+  while (todo.isNonEmpty()) {
+    Expression* e = todo.pop();
+    while (e->list) {
+      todo.push(List::pop(e->list));
+    }
+    delete e;
+  }
+}
+
 /**
  * Return a LISP string corresponding to this expression
  * @since 26/08/2009 Redmond
@@ -133,6 +133,12 @@ void NewCNF::clausify(FormulaUnit* unit,Stack<Clause*>& output)
 
   ASS(_queue.isEmpty());
   ASS(_occurrences.isEmpty());
+
+  // deleted entries count towards the capacity of a DHMap until it is reset,
+  // without the resets the maps would keep growing with every clausified unit
+  // and iterating over them would get slower and slower
+  _substitutionsByBindings.reset();
+  _occurrences.reset();
 }
 
 void NewCNF::process(Literal* literal, Occurrences &occurrences) {
@@ -1057,6 +1063,9 @@ void NewCNF::process(QuantifiedFormula* g, Occurrences &occurrences)
     BindingList::destroy(bindings);
     fdit.del();
   }
+  // forget the deleted entries, see the end of clausify()
+  _skolemsByFreeVars.reset();
+  _foolSkolemsByFreeVars.reset();
 
   // Note that the formula under quantifier reuses the quantified formula's occurrences
   enqueue(g->qarg(), occurrences);
@@ -103,6 +103,20 @@ void Options::Options::init()
     _memoryLimit.addHardConstraint(lessThanEq((unsigned)Lib::System::getSystemMemory()));
 #endif
 
+    _memoryPressureThreshold = UnsignedOptionValue("memory_pressure_threshold","mpt",0);
+    _memoryPressureThreshold.description="When the used memory gets over this percentage of the memory limit, saturation "
+      "tightens the passive limits so that about half of passive is discarded, and does so again each time half of the remaining "
+      "memory is used. This makes saturation incomplete. 0 means never.";
+    _lookup.insert(&_memoryPressureThreshold);
+    _memoryPressureThreshold.tag(OptionTag::SATURATION);
+    _memoryPressureThreshold.addConstraint(lessThan(100u));
+
+    _forkKeepsPiecesShared = BoolOptionValue("fork_keeps_pieces_shared","fkps",false);
+    _forkKeepsPiecesShared.description="Forked children (e.g. of the portfolio modes) do not place new objects in the free "
+      "pieces of memory left by the parent, so that the pages holding them stay shared with the parent instead of being copied. "
+      "The pieces then no longer count to the used memory of the child, but are not reused by it either.";
+    _lookup.insert(&_forkKeepsPiecesShared);
+
     _mode = ChoiceOptionValue<Mode>("mode","",Mode::VAMPIRE,
                                     {"axiom_selection",
                                         "casc",
@@ -119,6 +133,7 @@ void Options::Options::init()
                                         "profile",
                                         "random_strategy",
                                         "sat_solver",
+                                        "server",
                                         "smtcomp",
                                         "spider",
                                         "tclausify",
@@ -133,6 +148,7 @@ void Options::Options::init()
     "  -tpreprocess,tclausify: output modes for theory input (clauses are quantified\n      with sort information).\n"
     "  -output,profile: output information about the problem\n"
     "  -sat_solver: accepts problems in DIMACS and uses the internal sat solver\n      directly\n"
+    "  -server: loads the input file once and then runs the portfolio on every\n      problem file named on a line of the standard input, together with it\n"
     "Some modes are not currently maintained (get in touch if interested):\n"
     "  -bpa: perform bound propagation\n"
     "  -consequence_elimination: perform consequence elimination\n"
@@ -179,12 +195,12 @@ void Options::Options::init()
          "smtcomp_2018"});
     _schedule.description = "Schedule to be run by the portfolio mode. casc and smtcomp usually point to the most recent schedule in that category. Note that some old schedules may contain option values that are no longer supported - see ignore_missing.";
     _lookup.insert(&_schedule);
-    _schedule.reliesOnHard(Or(_mode.is(equal(Mode::CASC)),_mode.is(equal(Mode::CASC_SAT)),_mode.is(equal(Mode::SMTCOMP)),_mode.is(equal(Mode::PORTFOLIO))));
+    _schedule.reliesOnHard(Or(_mode.is(equal(Mode::CASC)),_mode.is(equal(Mode::CASC_SAT)),_mode.is(equal(Mode::SMTCOMP)),_mode.is(equal(Mode::PORTFOLIO)),_mode.is(equal(Mode::SERVER))));
 
     _multicore = UnsignedOptionValue("cores","",1);
     _multicore.description = "When running in portfolio modes (including casc or smtcomp modes) specify the number of cores, set to 0 to use maximum";
     _lookup.insert(&_multicore);
-    _multicore.reliesOnHard(Or(_mode.is(equal(Mode::CASC)),_mode.is(equal(Mode::CASC_SAT)),_mode.is(equal(Mode::SMTCOMP)),_mode.is(equal(Mode::PORTFOLIO))));
+    _multicore.reliesOnHard(Or(_mode.is(equal(Mode::CASC)),_mode.is(equal(Mode::CASC_SAT)),_mode.is(equal(Mode::SMTCOMP)),_mode.is(equal(Mode::PORTFOLIO)),_mode.is(equal(Mode::SERVER))));
 
     _ltbLearning = ChoiceOptionValue<LTBLearning>("ltb_learning","ltbl",LTBLearning::OFF,{"on","off","biased"});
     _ltbLearning.description = "Perform learning in LTB mode";
@@ -196,6 +212,11 @@ void Options::Options::init()
     _lookup.insert(&_ltbDirectory);
     _ltbDirectory.setExperimental();
 
+    _ltbAxiomSaturation = UnsignedOptionValue("ltb_axiom_saturation","ltbas",0);
+    _ltbAxiomSaturation.description = "In LTB mode, saturate the included axioms of a batch for this many steps once and let every problem continue from that saturation, using the strategy given on the command line instead of the schedule. 0 means off.";
+    _lookup.insert(&_ltbAxiomSaturation);
+    _ltbAxiomSaturation.setExperimental();
+
     _decode = DecodeOptionValue("decode","",this);
     _decode.description="Decodes an encoded strategy. Can be used to replay a strategy. To make Vampire output an encoded version of the strategy use the encode option.";
     _lookup.insert(&_decode);
@@ -319,6 +340,19 @@ void Options::Options::init()
     _lookup.insert(&_proofExtra);
     _proofExtra.tag(OptionTag::OUTPUT);
 
+    _proofHistory = ChoiceOptionValue<ProofHistory>("proof_history","",ProofHistory::CLAUSES,{"clauses","arena","spill"});
+    _proofHistory.description="How the derivations of clauses are kept for proof output during saturation:\n"
+      "- clauses keeps the premise clauses, which stay in memory as long as their descendants\n"
+      "- arena records the rule, premise numbers and literals of each new clause in an append-only arena,"
+      " so deleted clauses can be freed; the proof is rebuilt from the records when a refutation is found\n"
+      "- spill is arena with the full parts of the arena moved to a temporary file";
+    _lookup.insert(&_proofHistory);
+    _proofHistory.tag(OptionTag::OUTPUT);
+    _proofHistory.reliesOnHard(_splitting.is(equal(false)));
+    _proofHistory.reliesOnHard(_showSymbolElimination.is(equal(false)));
+    _proofHistory.reliesOnHard(_showInterpolant.is(equal(InterpolantMode::OFF)));
+    _proofHistory.reliesOnHard(_questionAnswering.is(equal(QuestionAnsweringMode::OFF)));
+
     _proofChecking = BoolOptionValue("proof_checking","",false);
     _proofChecking.description="";
     _lookup.insert(&_proofChecking);
@@ -846,6 +880,28 @@ void Options::Options::init()
     _lookup.insert(&_fmbSizeWeightRatio);
     _fmbSizeWeightRatio.tag(OptionTag::FMB);
 
+    _fmbGenerationThreads = UnsignedOptionValue("fmb_generation_threads","fmbgt",1);
+    _fmbGenerationThreads.description = "The number of threads used to generate instances, functionality and totality constraints for each model size (0 means one per core). The generated clauses are the same regardless of the value.";
+    _lookup.insert(&_fmbGenerationThreads);
+    _fmbGenerationThreads.tag(OptionTag::FMB);
+
+    _fmbIncremental = BoolOptionValue("fmb_incremental","fmbi",false);
+    _fmbIncremental.description = "Keep the SAT solver when the model sizes grow and only add the constraints that are new for the larger sizes. Learned clauses and the constraints generated so far survive between sizes, at the price of encoding a few sizes ahead.";
+    _lookup.insert(&_fmbIncremental);
+    _fmbIncremental.addHardConstraint(If(equal(true)).then(_fmbEnumerationStrategy.is(equal(FMBEnumerationStrategy::CONTOUR))));
+    _fmbIncremental.tag(OptionTag::FMB);
+
+    _fmbCliqueSymmetry = BoolOptionValue("fmb_clique_symmetry","fmbcs",false);
+    _fmbCliqueSymmetry.description = "Find a maximum set of pairwise distinct constants in each sort (already used to bound the sort size from below) and fix them to the first domain elements. The instances are simplified using the fixed values and the constants are put first in the symmetry breaking ordering.";
+    _lookup.insert(&_fmbCliqueSymmetry);
+    _fmbCliqueSymmetry.tag(OptionTag::FMB);
+
+    _fmbSizeWorkers = UnsignedOptionValue("fmb_size_workers","fmbsw",1);
+    _fmbSizeWorkers.description = "The number of domain size assignments tried at the same time, each in its own child process (0 means one per core). The nogoods learned by the children are used for the size assignments tried next, but are not passed to the children already running; a running child is only stopped when a nogood excludes its assignment. The first model found is reported. Only used when the sizes are not enumerated by contour.";
+    _fmbSizeWorkers.reliesOn(_fmbEnumerationStrategy.is(notEqual(FMBEnumerationStrategy::CONTOUR)));
+    _lookup.insert(&_fmbSizeWorkers);
+    _fmbSizeWorkers.tag(OptionTag::FMB);
+
     _fmbEnumerationStrategy = ChoiceOptionValue<FMBEnumerationStrategy>("fmb_enumeration_strategy","fmbes",FMBEnumerationStrategy::SBMEAM,{"sbeam",
 #if VZ3
         "smt",
@@ -907,6 +963,50 @@ void Options::Options::init()
     _lookup.insert(&_ageWeightRatioShapeFrequency);
     _ageWeightRatioShapeFrequency.tag(OptionTag::SATURATION);
 
+    _bucketPassiveQueue = BoolOptionValue("bucket_passive_queue","bpq",false);
+    _bucketPassiveQueue.description = "Keep passive clauses in buckets indexed by weight and age instead of two skip lists. "
+      "Clauses are selected in the same order, but adding, removing and selecting them does not depend on the size of passive. "
+      "With split queues, the queues inside them keep using skip lists.";
+    _lookup.insert(&_bucketPassiveQueue);
+    _bucketPassiveQueue.tag(OptionTag::SATURATION);
+
+    _compactPassive = BoolOptionValue("compact_passive","cpa",false);
+    _compactPassive.description = "Keep passive clauses as compact records (literals, age, weight and inference) and only build the clause objects "
+      "when they are selected. Needs a loop where passive clauses are not used for simplification, so it is only available with Discount and without AVATAR. "
+      "Clauses of equal age and weight are selected in the order they were added. "
+      "Terms are shared either way and the children of an activation are objects until they reach passive, "
+      "so this only helps when the passive clauses take more memory than the largest batch of children.";
+    _lookup.insert(&_compactPassive);
+    _compactPassive.tag(OptionTag::SATURATION);
+    _compactPassive.reliesOnHard(_saturationAlgorithm.is(equal(SaturationAlgorithm::DISCOUNT)));
+    _compactPassive.reliesOnHard(_splitting.is(equal(false)));
+    _compactPassive.reliesOnHard(_ageWeightRatioShape.is(equal(AgeWeightRatioShape::CONSTANT)));
+    // the other ways of clause selection would be ignored
+    _compactPassive.reliesOnHard(_manualClauseSelection.is(equal(false)));
+    _compactPassive.reliesOnHard(_clauseSelectionModel.is(equal(vstring(""))));
+    _compactPassive.reliesOnHard(_useTheorySplitQueues.is(equal(false)));
+    _compactPassive.reliesOnHard(_useAvatarSplitQueues.is(equal(false)));
+    _compactPassive.reliesOnHard(_useSineLevelSplitQueues.is(equal(false)));
+    _compactPassive.reliesOnHard(_usePositiveLiteralSplitQueues.is(equal(false)));
+
+    _historyGC = BoolOptionValue("history_gc","hgc",false);
+    _historyGC.description = "Free the clauses of the input problem once they are deleted and no live clause is derived from them, "
+      "as is done for the clauses derived during saturation. Otherwise they are kept until the end of the run. "
+      "The input formulas are kept either way.";
+    _lookup.insert(&_historyGC);
+    _historyGC.tag(OptionTag::SATURATION);
+    _historyGC.reliesOnHard(_saturationAlgorithm.is(notEqual(SaturationAlgorithm::INST_GEN)));
+
+    _clauseSelectionModel = StringOptionValue("clause_selection_model","csm","");
+    _clauseSelectionModel.description = "A name of a file with the coefficients of a linear model scoring clauses by cheap features "
+      "(weight, age, length, positive, equalities, variables, symbols, goal, sine_level, theory, splits), one feature name and coefficient per line, "
+      "the name bias standing for the absolute term. If given, clauses of the lowest score are selected instead of the lightest ones "
+      "and passive is not split into several queues. LRS limits are not used.";
+    _lookup.insert(&_clauseSelectionModel);
+    _clauseSelectionModel.tag(OptionTag::SATURATION);
+    _clauseSelectionModel.setExperimental();
+    _clauseSelectionModel.reliesOnHard(_ageWeightRatioShape.is(equal(AgeWeightRatioShape::CONSTANT)));
+
     _useTheorySplitQueues = BoolOptionValue("theory_split_queue","thsq",false);
     _useTheorySplitQueues.description = "Turn on clause selection using multiple queues containing different clauses (split by amount of theory reasoning)";
     _lookup.insert(&_useTheorySplitQueues);
@@ -1028,6 +1128,13 @@ void Options::Options::init()
       _lookup.insert(&_lrsWeightLimitOnly);
       _lrsWeightLimitOnly.tag(OptionTag::LRS);
 
+      _lrsHistogramLimits = BoolOptionValue("lrs_histogram_limits","lhl",true);
+      _lrsHistogramLimits.description=
+      "If on, the lrs computes the limits from the numbers of passive clauses of each weight and age, which are kept up to date, "
+      "instead of going through the passive clauses. The limits are the same either way, which debug builds check on every update.";
+      _lookup.insert(&_lrsHistogramLimits);
+      _lrsHistogramLimits.tag(OptionTag::LRS);
+
       _simulatedTimeLimit = TimeLimitOptionValue("simulated_time_limit","stl",0);
       _simulatedTimeLimit.description=
       "Time limit in seconds for the purpose of reachability estimations of the LRS saturation algorithm (if 0, the actual time limit is used)";
@@ -1341,6 +1448,14 @@ void Options::Options::init()
 	    _lookup.insert(&_forwardDemodulation);
 	    _forwardDemodulation.tag(OptionTag::INFERENCES);
 	    _forwardDemodulation.setRandomChoices({"all","all","all","off","preordered"});
+
+	    _forwardDemodulationGroundLookup = BoolOptionValue("forward_demodulation_ground_lookup","fdgl",true);
+	    _forwardDemodulationGroundLookup.description=
+	    "Rewrite ground terms in forward demodulation by looking them up among the left-hand sides"
+	    " of ground unit equalities before querying the index.";
+	    _lookup.insert(&_forwardDemodulationGroundLookup);
+	    _forwardDemodulationGroundLookup.tag(OptionTag::INFERENCES);
+	    _forwardDemodulationGroundLookup.reliesOn(_forwardDemodulation.is(notEqual(Demodulation::OFF)));
     
     _forwardLiteralRewriting = BoolOptionValue("forward_literal_rewriting","flr",false);
     _forwardLiteralRewriting.description="Perform forward literal rewriting.";
@@ -1476,6 +1591,12 @@ void Options::Options::init()
     _instGenPassiveReactivation.tag(OptionTag::INST_GEN);
     _instGenPassiveReactivation.reliesOn(_saturationAlgorithm.is(equal(SaturationAlgorithm::INST_GEN)));
 
+    _instGenIncrementalRestart = BoolOptionValue("inst_gen_incremental_restart","igir",false);
+    _instGenIncrementalRestart.description="Make restarts cheaper. A small restart keeps the indexes and only sends the active clauses whose selected literals are no longer true in the model back to passive. Clauses that are variants of an already grounded clause are not grounded and added to the SAT solver again, also across big restarts.";
+    _lookup.insert(&_instGenIncrementalRestart);
+    _instGenIncrementalRestart.tag(OptionTag::INST_GEN);
+    _instGenIncrementalRestart.reliesOn(_saturationAlgorithm.is(equal(SaturationAlgorithm::INST_GEN)));
+
     _instGenResolutionInstGenRatio = RatioOptionValue("inst_gen_resolution_ratio","igrr",1,1,'/');
     _instGenResolutionInstGenRatio.description=
     "Ratio of resolution and instantiation steps (applies only if inst_gen_with_resolution is on)";
@@ -278,6 +278,11 @@ public:
     FREE,
     FULL
   };
+  enum class ProofHistory : unsigned int {
+    CLAUSES,
+    ARENA,
+    SPILL
+  };
   enum class FMBWidgetOrders : unsigned int {
     FUNCTION_FIRST, // f(1) f(2) f(3) ... g(1) g(2) ...
     ARGUMENT_FIRST, // f(1) g(1) h(1) ... f(2) g(2) ...
@@ -424,6 +429,7 @@ public:
     PROFILE,
     RANDOM_STRATEGY,
     SAT,
+    SERVER,
     SMTCOMP,
     SPIDER,
     TCLAUSIFY,
@@ -1956,6 +1962,7 @@ public:
   Proof proof() const { return _proof.actualValue; }
   bool minimizeSatProofs() const { return _minimizeSatProofs.actualValue; }
   ProofExtra proofExtra() const { return _proofExtra.actualValue; }
+  ProofHistory proofHistory() const { return _proofHistory.actualValue; }
   bool proofChecking() const { return _proofChecking.actualValue; }
   int naming() const { return _naming.actualValue; }
 
@@ -1969,10 +1976,15 @@ public:
   unsigned fmbDetectSortBoundsTimeLimit() const { return _fmbDetectSortBoundsTimeLimit.actualValue; }
   unsigned fmbSizeWeightRatio() const { return _fmbSizeWeightRatio.actualValue; }
   FMBEnumerationStrategy fmbEnumerationStrategy() const { return _fmbEnumerationStrategy.actualValue; }
+  unsigned fmbGenerationThreads() const { return _fmbGenerationThreads.actualValue; }
+  bool fmbIncremental() const { return _fmbIncremental.actualValue; }
+  bool fmbCliqueSymmetry() const { return _fmbCliqueSymmetry.actualValue; }
+  unsigned fmbSizeWorkers() const { return _fmbSizeWorkers.actualValue; }
 
   bool flattenTopLevelConjunctions() const { return _flattenTopLevelConjunctions.actualValue; }
   LTBLearning ltbLearning() const { return _ltbLearning.actualValue; }
   vstring ltbDirectory() const { return _ltbDirectory.actualValue; }
+  unsigned ltbAxiomSaturation() const { return _ltbAxiomSaturation.actualValue; }
   Mode mode() const { return _mode.actualValue; }
   Schedule schedule() const { return _schedule.actualValue; }
   vstring scheduleName() const { return _schedule.getStringOfValue(_schedule.actualValue); }
@@ -2062,6 +2074,7 @@ public:
   bool forwardSubsumptionDemodulation() const { return _forwardSubsumptionDemodulation.actualValue; }
   unsigned forwardSubsumptionDemodulationMaxMatches() const { return _forwardSubsumptionDemodulationMaxMatches.actualValue; }
   Demodulation forwardDemodulation() const { return _forwardDemodulation.actualValue; }
+  bool forwardDemodulationGroundLookup() const { return _forwardDemodulationGroundLookup.actualValue; }
   bool binaryResolution() const { return _binaryResolution.actualValue; }
   bool bfnt() const { return _bfnt.actualValue; }
   void setBfnt(bool newVal) { _bfnt.actualValue = newVal; }
@@ -2084,6 +2097,7 @@ public:
   bool forwardLiteralRewriting() const { return _forwardLiteralRewriting.actualValue; }
   int lrsFirstTimeCheck() const { return _lrsFirstTimeCheck.actualValue; }
   int lrsWeightLimitOnly() const { return _lrsWeightLimitOnly.actualValue; }
+  bool lrsHistogramLimits() const { return _lrsHistogramLimits.actualValue; }
   int lookaheadDelay() const { return _lookaheadDelay.actualValue; }
   int simulatedTimeLimit() const { return _simulatedTimeLimit.actualValue; }
   void setSimulatedTimeLimit(int newVal) { _simulatedTimeLimit.actualValue = newVal; }
@@ -2100,6 +2114,8 @@ public:
   // Return time limit in deciseconds, or 0 if there is no time limit
   int timeLimitInDeciseconds() const { return _timeLimitInDeciseconds.actualValue; }
   size_t memoryLimit() const { return _memoryLimit.actualValue; }
+  bool forkKeepsPiecesShared() const { return _forkKeepsPiecesShared.actualValue; }
+  unsigned memoryPressureThreshold() const { return _memoryPressureThreshold.actualValue; }
   int inequalitySplitting() const { return _inequalitySplitting.actualValue; }
   long maxActive() const { return _maxActive.actualValue; }
   long maxAnswers() const { return _maxAnswers.actualValue; }
@@ -2128,6 +2144,10 @@ public:
   void setWeightRatio(int v){ _ageWeightRatio.otherValue = v; }
 	AgeWeightRatioShape ageWeightRatioShape() const { return _ageWeightRatioShape.actualValue; }
 	int ageWeightRatioShapeFrequency() const { return _ageWeightRatioShapeFrequency.actualValue; }
+  bool bucketPassiveQueue() const { return _bucketPassiveQueue.actualValue; }
+  bool compactPassive() const { return _compactPassive.actualValue; }
+  bool historyGC() const { return _historyGC.actualValue; }
+  const vstring& clauseSelectionModel() const { return _clauseSelectionModel.actualValue; }
   bool literalMaximalityAftercheck() const { return _literalMaximalityAftercheck.actualValue; }
   bool superpositionFromVariables() const { return _superpositionFromVariables.actualValue; }
   EqualityProxy equalityProxy() const { return _equalityProxy.actualValue; }
@@ -2205,6 +2225,7 @@ public:
 
   float instGenBigRestartRatio() const { return _instGenBigRestartRatio.actualValue; }
   bool instGenPassiveReactivation() const { return _instGenPassiveReactivation.actualValue; }
+  bool instGenIncrementalRestart() const { return _instGenIncrementalRestart.actualValue; }
   int instGenResolutionRatioInstGen() const { return _instGenResolutionInstGenRatio.actualValue; }
   int instGenResolutionRatioResolution() const { return _instGenResolutionInstGenRatio.otherValue; }
   int instGenRestartPeriod() const { return _instGenRestartPeriod.actualValue; }
@@ -2386,6 +2407,10 @@ private:
   RatioOptionValue _ageWeightRatio;
 	ChoiceOptionValue<AgeWeightRatioShape> _ageWeightRatioShape;
 	UnsignedOptionValue _ageWeightRatioShapeFrequency;
+  BoolOptionValue _bucketPassiveQueue;
+  BoolOptionValue _compactPassive;
+  BoolOptionValue _historyGC;
+  StringOptionValue _clauseSelectionModel;
   BoolOptionValue _useTheorySplitQueues;
   StringOptionValue _theorySplitQueueRatios;
   StringOptionValue _theorySplitQueueCutoffs;
@@ -2454,12 +2479,17 @@ private:
   UnsignedOptionValue _fmbDetectSortBoundsTimeLimit;
   UnsignedOptionValue _fmbSizeWeightRatio;
   ChoiceOptionValue<FMBEnumerationStrategy> _fmbEnumerationStrategy;
+  UnsignedOptionValue _fmbGenerationThreads;
+  BoolOptionValue _fmbIncremental;
+  BoolOptionValue _fmbCliqueSymmetry;
+  UnsignedOptionValue _fmbSizeWorkers;
 
   BoolOptionValue _flattenTopLevelConjunctions;
   StringOptionValue _forbiddenOptions;
   BoolOptionValue _forceIncompleteness;
   StringOptionValue _forcedOptions;
   ChoiceOptionValue<Demodulation> _forwardDemodulation;
+  BoolOptionValue _forwardDemodulationGroundLookup;
   BoolOptionValue _forwardLiteralRewriting;
   BoolOptionValue _forwardSubsumption;
   BoolOptionValue _forwardSubsumptionResolution;
@@ -2499,6 +2529,7 @@ private:
   ChoiceOptionValue<Instantiation> _instantiation;
   FloatOptionValue _instGenBigRestartRatio;
   BoolOptionValue _instGenPassiveReactivation;
+  BoolOptionValue _instGenIncrementalRestart;
   RatioOptionValue _instGenResolutionInstGenRatio;
   //IntOptionValue _instGenResolutionRatioResolution;
   IntOptionValue _instGenRestartPeriod;
@@ -2526,8 +2557,10 @@ private:
   IntOptionValue _lookaheadDelay;
   IntOptionValue _lrsFirstTimeCheck;
   BoolOptionValue _lrsWeightLimitOnly;
+  BoolOptionValue _lrsHistogramLimits;
   ChoiceOptionValue<LTBLearning> _ltbLearning;
   StringOptionValue _ltbDirectory;
+  UnsignedOptionValue _ltbAxiomSaturation;
 
   LongOptionValue _maxActive;
   IntOptionValue _maxAnswers;
@@ -2535,6 +2568,8 @@ private:
   LongOptionValue _maxPassive;
   UnsignedOptionValue _maximalPropagatedEqualityLength;
   UnsignedOptionValue _memoryLimit; // should be size_t, making an assumption
+  BoolOptionValue _forkKeepsPiecesShared;
+  UnsignedOptionValue _memoryPressureThreshold;
   ChoiceOptionValue<Mode> _mode;
   ChoiceOptionValue<Schedule> _schedule;
   UnsignedOptionValue _multicore;
@@ -2552,6 +2587,7 @@ private:
   ChoiceOptionValue<Proof> _proof;
   BoolOptionValue _minimizeSatProofs;
   ChoiceOptionValue<ProofExtra> _proofExtra;
+  ChoiceOptionValue<ProofHistory> _proofHistory;
   BoolOptionValue _proofChecking;
   
   StringOptionValue _protectedPrefix;
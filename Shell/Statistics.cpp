@@ -123,6 +123,7 @@ Statistics::Statistics()
     activeClauses(0),
     extensionalityClauses(0),
     discardedNonRedundantClauses(0),
+    memoryPressureReactions(0),
     inferencesBlockedForOrderingAftercheck(0),
     smtReturnedUnknown(false),
     smtDidNotEvaluate(false),
@@ -267,7 +268,7 @@ void Statistics::print(ostream& out)
 
   HEADING("Saturation",activeClauses+passiveClauses+extensionalityClauses+
       generatedClauses+finalActiveClauses+finalPassiveClauses+finalExtensionalityClauses+
-      discardedNonRedundantClauses+inferencesSkippedDueToColors+inferencesBlockedForOrderingAftercheck);
+      discardedNonRedundantClauses+memoryPressureReactions+inferencesSkippedDueToColors+inferencesBlockedForOrderingAftercheck);
   COND_OUT("Initial clauses", initialClauses);
   COND_OUT("Generated clauses", generatedClauses);
   COND_OUT("Active clauses", activeClauses);
@@ -278,6 +279,7 @@ void Statistics::print(ostream& out)
   COND_OUT("Final passive clauses", finalPassiveClauses);
   COND_OUT("Final extensionality clauses", finalExtensionalityClauses);
   COND_OUT("Discarded non-redundant clauses", discardedNonRedundantClauses);
+  COND_OUT("Passive reductions due to memory pressure", memoryPressureReactions);
   COND_OUT("Inferences skipped due to colors", inferencesSkippedDueToColors);
   COND_OUT("Inferences blocked due to ordering aftercheck", inferencesBlockedForOrderingAftercheck);
   SEPARATOR;
@@ -402,6 +404,12 @@ void Statistics::print(ostream& out)
   }
 
   COND_OUT("Memory used [KB]", Allocator::getUsedMemory()/1024);
+  if (env.options->statistics()==Options::Statistics::FULL) {
+    for (unsigned i = 0; i < Allocator::SUBSYSTEM_CNT; i++) {
+      Allocator::Subsystem s = static_cast<Allocator::Subsystem>(i);
+      COND_OUT(vstring("Memory used by ")+Allocator::subsystemName(s)+" [KB]", Allocator::getUsedMemory(s)/1024);
+    }
+  }
 
   addCommentSignForSZS(out);
   out << "Time elapsed: ";
@@ -208,6 +208,8 @@ public:
   unsigned extensionalityClauses;
 
   unsigned discardedNonRedundantClauses;
+  /** number of times passive was shrunk because of memory pressure */
+  unsigned memoryPressureReactions;
 
   unsigned inferencesBlockedForOrderingAftercheck;
 
@@ -0,0 +1,154 @@
+/*
+ * File tClauseBucketQueue.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file tClauseBucketQueue.cpp
+ * Unit test checking that ClauseBucketQueue keeps the orders of
+ * the skip list based WeightQueue and AgeQueue
+ */
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID bucket_queue
+UT_CREATE;
+
+#include "Lib/Environment.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/Stack.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/ClauseBucketQueue.hpp"
+#include "Kernel/Unit.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "Saturation/AWPassiveClauseContainer.hpp"
+
+#include "Shell/Options.hpp"
+
+using namespace Lib;
+using namespace Kernel;
+using namespace Saturation;
+using namespace Shell;
+
+/**
+ * Parse @b cnt clauses of various weights, ages and input types,
+ * with many of them sharing both the weight and the age
+ */
+static void makeClauses(unsigned cnt, Stack<Clause*>& res)
+{
+  vstring text;
+  for (unsigned i=0; i<cnt; i++) {
+    text += "cnf(c"+Int::toString(i)+","+((i%5) ? "axiom" : "negated_conjecture")+",";
+    for (unsigned l=0; l<=i%3; l++) {
+      if (l) {
+        text += " | ";
+      }
+      vstring term = "a";
+      for (unsigned d=0; d<(i+l)%4; d++) {
+        term = "f("+term+")";
+      }
+      text += ((i+l)%2 ? "p(" : "~q(")+term+")";
+    }
+    text += ").\n";
+  }
+  vistringstream inp(text);
+  UnitList::Iterator uit(Parse::TPTP::parse(inp));
+  unsigned i = 0;
+  while (uit.hasNext()) {
+    Clause* cl = static_cast<Clause*>(uit.next());
+    cl->setAge((i*7)%6);
+    cl->incRefCnt();
+    res.push(cl);
+    i++;
+  }
+  ASS_EQ(res.size(), cnt);
+}
+
+static void checkIterator(ClauseBucketQueue& queue, ClauseQueue& oracle, bool byWeight)
+{
+  ClauseBucketQueue::Iterator it(queue, byWeight);
+  ClauseQueue::Iterator oit(oracle);
+  while (oit.hasNext()) {
+    Clause* expected = oit.next();
+    ASS(it.hasNext());
+    Clause* cl = it.next();
+    ASS_EQ(cl, expected);
+  }
+  ASS(!it.hasNext());
+}
+
+TEST_FUN(orderAndRemoval)
+{
+  Stack<Clause*> clauses;
+  makeClauses(200, clauses);
+
+  ClauseBucketQueue queue(*env.options);
+  WeightQueue byWeight(*env.options);
+  AgeQueue byAge(*env.options);
+  Stack<Clause*>::Iterator cit(clauses);
+  while (cit.hasNext()) {
+    Clause* cl = cit.next();
+    queue.insert(cl);
+    byWeight.insert(cl);
+    byAge.insert(cl);
+  }
+  checkIterator(queue, byWeight, true);
+  checkIterator(queue, byAge, false);
+
+  // remove from the middle, the front and the back of buckets
+  for (unsigned i=0; i<clauses.size(); i+=3) {
+    Clause* cl = clauses[i];
+    ALWAYS(queue.remove(cl));
+    NEVER(queue.remove(cl));
+    ALWAYS(byWeight.remove(cl));
+    ALWAYS(byAge.remove(cl));
+  }
+  checkIterator(queue, byWeight, true);
+  checkIterator(queue, byAge, false);
+
+  // pop with the age to weight ratio 1:2
+  unsigned step = 0;
+  while (!byWeight.isEmpty()) {
+    ASS(!queue.isEmpty());
+    Clause* cl;
+    if (step++%3==0) {
+      cl = queue.popByAge();
+      Clause* expected = byAge.pop();
+      ASS_EQ(cl, expected);
+      ALWAYS(byWeight.remove(cl));
+    }
+    else {
+      cl = queue.popByWeight();
+      Clause* expected = byWeight.pop();
+      ASS_EQ(cl, expected);
+      ALWAYS(byAge.remove(cl));
+    }
+    NEVER(queue.remove(cl));
+  }
+  ASS(queue.isEmpty());
+  ASS(byAge.isEmpty());
+
+  // the clauses can be queued again after they left
+  queue.insert(clauses[0]);
+  queue.insert(clauses[1]);
+  ALWAYS(queue.remove(clauses[1]));
+  Clause* last = queue.popByWeight();
+  ASS_EQ(last, clauses[0]);
+  ASS(queue.isEmpty());
+}
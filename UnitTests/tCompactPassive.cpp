@@ -0,0 +1,258 @@
+/*
+ * File tCompactPassive.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file tCompactPassive.cpp
+ * Unit test of CompactPassiveClauseContainer and of the options it relies on
+ */
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID compact_passive
+UT_CREATE;
+
+#include "Lib/DHMap.hpp"
+#include "Lib/Environment.hpp"
+#include "Lib/Exception.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/ScopedPtr.hpp"
+#include "Lib/Stack.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/MainLoop.hpp"
+#include "Kernel/Problem.hpp"
+#include "Kernel/Unit.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "Saturation/AWPassiveClauseContainer.hpp"
+#include "Saturation/CompactPassiveClauseContainer.hpp"
+#include "Saturation/SaturationAlgorithm.hpp"
+
+#include "Shell/Options.hpp"
+#include "Shell/Preprocess.hpp"
+#include "Shell/Statistics.hpp"
+
+using namespace Lib;
+using namespace Kernel;
+using namespace Saturation;
+using namespace Shell;
+
+static void setCompactPassive(Options& opt)
+{
+  opt.set("saturation_algorithm", "discount");
+  opt.set("avatar", "off");
+  opt.set("compact_passive", "on");
+}
+
+/**
+ * True if checkGlobalOptionConstraints accepts compact_passive
+ * with @b name set to @b value
+ */
+static bool accepted(const char* name, const char* value)
+{
+  Options opt;
+  setCompactPassive(opt);
+  opt.set(name, value);
+  try {
+    return opt.checkGlobalOptionConstraints();
+  }
+  catch (UserErrorException&) {
+    return false;
+  }
+}
+
+TEST_FUN(incompatibleOptions)
+{
+  ASS(accepted("age_weight_ratio", "1:4"));
+  ASS(!accepted("saturation_algorithm", "lrs"));
+  ASS(!accepted("avatar", "on"));
+  ASS(!accepted("manual_cs", "on"));
+  ASS(!accepted("clause_selection_model", "model.txt"));
+  ASS(!accepted("theory_split_queue", "on"));
+  ASS(!accepted("avatar_split_queue", "on"));
+  ASS(!accepted("sine_level_split_queue", "on"));
+  ASS(!accepted("positive_literal_split_queue", "on"));
+}
+
+/**
+ * Let the clauses created from now on be compacted. Clauses from
+ * preprocessing keep a reference of the problem and are not compacted.
+ */
+static void endPreprocessing()
+{
+  static bool ended = false;
+  if (!ended) {
+    Unit::onPreprocessingEnd();
+    ended = true;
+  }
+}
+
+// runs before compactAndRebuild, whose clauses are made after preprocessing
+TEST_FUN(saturation)
+{
+  Options& opt = *env.options;
+  Options saved(opt);
+  setCompactPassive(opt);
+
+  vistringstream inp(
+      "cnf(a1,axiom,p(a)).\n"
+      "cnf(a2,axiom,~p(X) | p(f(X))).\n"
+      "cnf(a3,axiom,~p(f(f(f(a)))) | q(b)).\n"
+      "cnf(a4,axiom,~q(X) | r(X)).\n"
+      "cnf(a5,axiom,p(g(X)) | ~r(X)).\n"
+      "cnf(g,negated_conjecture,~p(f(g(b)))).\n");
+  ScopedPtr<Problem> prb(new Problem(Parse::TPTP::parse(inp)));
+  Preprocess prepro(opt);
+  prepro.preprocess(*prb);
+  endPreprocessing();
+  {
+    ScopedPtr<SaturationAlgorithm> salg(SaturationAlgorithm::createFromOptions(*prb, opt));
+    MainLoopResult res = salg->run();
+    ASS_EQ(res.terminationReason, Statistics::REFUTATION);
+  }
+
+  opt = saved;
+}
+
+static vstring literalsOf(Clause* cl)
+{
+  vstring res;
+  for (unsigned i=0; i<cl->length(); i++) {
+    res += (*cl)[i]->toString()+" ";
+  }
+  return res;
+}
+
+/**
+ * Add @b cnt clauses to a CompactPassiveClauseContainer and check that they
+ * come back in the order of AWPassiveClauseContainer and as they were
+ */
+static void checkSelection(unsigned cnt)
+{
+  Options opt;
+  setCompactPassive(opt);
+  opt.set("age_weight_ratio", "1:2");
+
+  vstring text;
+  for (unsigned i=0; i<cnt; i++) {
+    text += "cnf(c"+Int::toString(i)+",axiom,";
+    for (unsigned l=0; l<=i%3; l++) {
+      vstring term = "a";
+      for (unsigned d=0; d<(i+l)%4; d++) {
+        term = "f("+term+")";
+      }
+      text += vstring(l ? " | " : "")+((i+l)%2 ? "p(" : "~q(")+term+")";
+    }
+    text += ").\n";
+  }
+  vistringstream inp(text);
+  Stack<Unit*> inputs;
+  inputs.loadFromIterator(UnitList::Iterator(Parse::TPTP::parse(inp)));
+  endPreprocessing();
+
+  // clauses are added in the order of their numbers, and the parser
+  // returns the units in the reverse order
+  Stack<Clause*> clauses;
+  for (unsigned i=0; i<inputs.size(); i++) {
+    Clause* cl = Clause::fromClause(static_cast<Clause*>(inputs[inputs.size()-1-i]));
+    cl->setAge((i*7)%5);
+    cl->setStore(Clause::PASSIVE);
+    clauses.push(cl);
+  }
+
+  // every fifth clause is also referenced from elsewhere, so it must stay an
+  // object, and one of those is removed before it is selected
+  Clause* removed = clauses[10];
+
+  // the expected order of selection
+  Stack<unsigned> expected;
+  {
+    AWPassiveClauseContainer aw(false, opt, "");
+    Stack<Clause*>::Iterator cit(clauses);
+    while (cit.hasNext()) {
+      aw.add(cit.next());
+    }
+    aw.remove(removed);
+    while (!aw.isEmpty()) {
+      expected.push(aw.popSelected()->number());
+    }
+  }
+  DHMap<unsigned,vstring> literals;
+  DHMap<unsigned,unsigned> ages;
+  Stack<Clause*>::Iterator cit(clauses);
+  while (cit.hasNext()) {
+    Clause* cl = cit.next();
+    literals.insert(cl->number(), literalsOf(cl));
+    ages.insert(cl->number(), cl->age());
+  }
+
+  CompactPassiveClauseContainer passive(false, opt);
+  for (unsigned j=0; j<clauses.size(); j++) {
+    if (j%5==0) {
+      clauses[j]->incRefCnt();
+    }
+    passive.add(clauses[j]);
+  }
+  passive.remove(removed);
+  removed->setStore(Clause::NONE);
+  ASS_EQ(passive.sizeEstimate(), clauses.size()-1);
+
+  DHMap<unsigned,Clause*> referenced;
+  for (unsigned j=0; j<clauses.size(); j+=5) {
+    if (j!=10) {
+      referenced.insert(clauses[j]->number(), clauses[j]);
+    }
+  }
+
+  Stack<unsigned>::BottomFirstIterator eit(expected);
+  while (eit.hasNext()) {
+    unsigned number = eit.next();
+    ASS(!passive.isEmpty());
+    Clause* cl = passive.popSelected();
+    ASS_EQ(cl->number(), number);
+    ASS_EQ(literalsOf(cl), literals.get(number));
+    ASS_EQ(cl->age(), ages.get(number));
+    ASS_EQ(cl->store(), Clause::PASSIVE);
+    Clause* orig;
+    if (referenced.find(number, orig)) {
+      // the same object with only the outside reference left
+      ASS_EQ(cl, orig);
+      ASS_EQ(cl->refCnt(), 1u);
+      cl->decRefCnt();
+    }
+    else {
+      ASS_EQ(cl->refCnt(), 0u);
+    }
+    cl->setStore(Clause::NONE);
+  }
+  ASS(passive.isEmpty());
+  removed->decRefCnt();
+}
+
+TEST_FUN(compactAndRebuild)
+{
+  checkSelection(60);
+}
+
+// enough clauses for several record and literal chunks and for the garbage
+// of the selected ones to be collected
+TEST_FUN(manyClauses)
+{
+  checkSelection(40000);
+}
@@ -0,0 +1,141 @@
+/*
+ * File tHistoryGC.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file tHistoryGC.cpp
+ * Unit test of handing the clauses of a problem over to reference
+ * counting, as done with history_gc
+ */
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID history_gc
+UT_CREATE;
+
+#include "Lib/Environment.hpp"
+#include "Lib/ScopedPtr.hpp"
+#include "Lib/Stack.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/InferenceStore.hpp"
+#include "Kernel/MainLoop.hpp"
+#include "Kernel/Problem.hpp"
+#include "Kernel/Unit.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "Saturation/SaturationAlgorithm.hpp"
+
+#include "Shell/Options.hpp"
+#include "Shell/Preprocess.hpp"
+#include "Shell/Statistics.hpp"
+
+using namespace Lib;
+using namespace Kernel;
+using namespace Saturation;
+using namespace Shell;
+
+/**
+ * Find the clause of @b units whose literals are printed as @b lit
+ */
+static Clause* findClause(UnitList* units, const vstring& lit)
+{
+  UnitList::Iterator uit(units);
+  while (uit.hasNext()) {
+    Unit* u = uit.next();
+    if (u->isClause() && static_cast<Clause*>(u)->literalsOnlyToString()==lit) {
+      return static_cast<Clause*>(u);
+    }
+  }
+  return 0;
+}
+
+// runs before preprocessing ends, so the clauses are from preprocessing
+TEST_FUN(releaseClauses)
+{
+  vistringstream inp(
+      "cnf(a1,axiom,p(a)).\n"
+      "cnf(a2,axiom,~p(X) | q(X)).\n");
+  UnitList* units = Parse::TPTP::parse(inp);
+  Clause* a1 = findClause(units, "p(a)");
+  Clause* a2 = findClause(units, "q(X0) | ~p(X0)");
+  ASS(a1);
+  ASS(a2);
+  ASS(a1->isFromPreprocessing());
+
+  Problem prb(units);
+  // the reference from preprocessing and the one of the problem
+  ASS_EQ(a1->refCnt(), 2u);
+  a1->incRefCnt();
+  a2->incRefCnt();
+
+  prb.releaseClauses();
+  ASS(UnitList::isEmpty(prb.units()));
+  ASS_EQ(a1->refCnt(), 1u);
+  ASS_EQ(a2->refCnt(), 1u);
+  a1->decRefCnt();
+  a2->decRefCnt();
+}
+
+TEST_FUN(proofWithHistoryGC)
+{
+  Options& opt = *env.options;
+  Options saved(opt);
+  opt.set("history_gc", "on");
+  opt.set("proof", "on");
+
+  vistringstream inp(
+      "cnf(a1,axiom,p(a)).\n"
+      "cnf(a2,axiom,~p(X) | p(f(X))).\n"
+      "cnf(a3,axiom,~p(f(f(a))) | q(b)).\n"
+      "cnf(t,axiom,r(X) | ~r(X)).\n"
+      "cnf(g,negated_conjecture,~q(b)).\n");
+  ScopedPtr<Problem> prb(new Problem(Parse::TPTP::parse(inp)));
+  Clause* taut = findClause(prb->units(), "~r(X0) | r(X0)");
+  ASS(taut);
+  taut->incRefCnt();
+
+  Preprocess prepro(opt);
+  prepro.preprocess(*prb);
+  Unit::onPreprocessingEnd();
+  // the reference from preprocessing, the one of the problem and ours
+  ASS_EQ(taut->refCnt(), 3u);
+
+  vostringstream proof;
+  {
+    ScopedPtr<SaturationAlgorithm> salg(SaturationAlgorithm::createFromOptions(*prb, opt));
+    MainLoopResult res = salg->run();
+    ASS_EQ(res.terminationReason, Statistics::REFUTATION);
+    // the tautology was deleted, and only our reference is left
+    // as the problem handed the clause over
+    ASS_EQ(taut->store(), Clause::NONE);
+    ASS_EQ(taut->refCnt(), 1u);
+    InferenceStore::instance()->outputProof(proof, res.refutation);
+  }
+  taut->decRefCnt();
+
+  // the input clauses of the proof were alive when it was printed
+  vstring text = proof.str();
+  ASS(text.find("p(a) [input]") != vstring::npos);
+  ASS(text.find("p(f(X0)) | ~p(X0) [input]") != vstring::npos);
+  ASS(text.find("q(b) | ~p(f(f(a))) [input]") != vstring::npos);
+  ASS(text.find("~q(b) [input]") != vstring::npos);
+  ASS(text.find("r(X0)") == vstring::npos);
+
+  opt = saved;
+}
@@ -384,3 +384,21 @@ TEST_FUN(kbo_test22) {
 }
 
 
+
+TEST_FUN(kbo_test23) {
+  FOF_SYNTAX_SUGAR
+  FOF_SYNTAX_SUGAR_FUN  (f, 2)
+  FOF_SYNTAX_SUGAR_FUN  (g, 1)
+  FOF_SYNTAX_SUGAR_CONST(a)
+  FOF_SYNTAX_SUGAR_CONST(b)
+
+  auto ord = kbo(weights(), weights());
+
+  // ground terms of the same weight, compared twice to get the cached result as well
+  for (int i = 0; i < 2; i++) {
+    ASS_EQ(ord.compare(f(a, g(b)), g(f(a, b))), Ordering::Result::LESS)
+    ASS_EQ(ord.compare(g(f(a, b)), f(a, g(b))), Ordering::Result::GREATER)
+  }
+  ASS_EQ(ord.compare(f(x, g(b)), g(f(x, b))), Ordering::Result::LESS)
+  ASS_EQ(ord.compare(f(x, g(b)), g(f(y, b))), Ordering::Result::INCOMPARABLE)
+}
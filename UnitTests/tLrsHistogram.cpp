@@ -0,0 +1,170 @@
+/*
+ * File tLrsHistogram.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file tLrsHistogram.cpp
+ * Unit test checking that the LRS limits computed from AgeWeightHistogram
+ * are the ones the simulation of the clause selection gives
+ */
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID lrs_histogram
+UT_CREATE;
+
+#include "Lib/Environment.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/Stack.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/Unit.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "Saturation/AWPassiveClauseContainer.hpp"
+
+#include "Shell/Options.hpp"
+
+using namespace Lib;
+using namespace Kernel;
+using namespace Saturation;
+using namespace Shell;
+
+/**
+ * Parse @b cnt passive clauses of various weights and ages,
+ * with many of them sharing both the weight and the age
+ */
+static void makeClauses(unsigned cnt, Stack<Clause*>& res)
+{
+  vstring text;
+  for (unsigned i=0; i<cnt; i++) {
+    text += "cnf(c"+Int::toString(i)+",axiom,";
+    for (unsigned l=0; l<=i%3; l++) {
+      if (l) {
+        text += " | ";
+      }
+      vstring term = "a";
+      for (unsigned d=0; d<(i+l)%4; d++) {
+        term = "f("+term+")";
+      }
+      text += ((i+l)%2 ? "p(" : "~q(")+term+")";
+    }
+    text += ").\n";
+  }
+  vistringstream inp(text);
+  UnitList::Iterator uit(Parse::TPTP::parse(inp));
+  unsigned i = 0;
+  while (uit.hasNext()) {
+    Clause* cl = static_cast<Clause*>(uit.next());
+    cl->setAge((i*7)%6);
+    cl->setStore(Clause::PASSIVE);
+    cl->incRefCnt();
+    res.push(cl);
+    i++;
+  }
+}
+
+static void checkSameLimits(AWPassiveClauseContainer& hist, AWPassiveClauseContainer& sim, Stack<Clause*>& clauses)
+{
+  ASS_EQ(hist.ageLimited(), sim.ageLimited());
+  ASS_EQ(hist.weightLimited(), sim.weightLimited());
+  Stack<Clause*>::Iterator cit(clauses);
+  while (cit.hasNext()) {
+    Clause* cl = cit.next();
+    ASS_EQ(hist.fulfilsAgeLimit(cl), sim.fulfilsAgeLimit(cl));
+    ASS_EQ(hist.fulfilsWeightLimit(cl), sim.fulfilsWeightLimit(cl));
+  }
+}
+
+TEST_FUN(cellOrders)
+{
+  AgeWeightHistogram h;
+  h.add(3, 1);
+  h.add(3, 1);
+  h.add(2, 5);
+  h.add(7, 0);
+  h.add(3, 4);
+  h.remove(3, 4);
+  ASS_EQ(h.total(), 4u);
+  ASS_EQ(h.count(3, 1), 2u);
+  ASS_EQ(h.count(3, 4), 0u);
+
+  unsigned weight = 0;
+  unsigned age = 0;
+  ALWAYS(h.findByWeight(weight, age));
+  ASS_EQ(weight, 2u); ASS_EQ(age, 5u);
+  age++;
+  ALWAYS(h.findByWeight(weight, age));
+  ASS_EQ(weight, 3u); ASS_EQ(age, 1u);
+  age++;
+  ALWAYS(h.findByWeight(weight, age));
+  ASS_EQ(weight, 7u); ASS_EQ(age, 0u);
+  age++;
+  NEVER(h.findByWeight(weight, age));
+
+  weight = 0;
+  age = 0;
+  ALWAYS(h.findByAge(weight, age));
+  ASS_EQ(weight, 7u); ASS_EQ(age, 0u);
+  weight++;
+  ALWAYS(h.findByAge(weight, age));
+  ASS_EQ(weight, 3u); ASS_EQ(age, 1u);
+  weight++;
+  ALWAYS(h.findByAge(weight, age));
+  ASS_EQ(weight, 2u); ASS_EQ(age, 5u);
+  weight++;
+  NEVER(h.findByAge(weight, age));
+}
+
+TEST_FUN(sameLimitsAsSimulation)
+{
+  Options histOpt;
+  histOpt.set("saturation_algorithm", "lrs");
+  histOpt.set("age_weight_ratio", "2:3");
+  histOpt.set("lrs_histogram_limits", "on");
+  Options simOpt(histOpt);
+  simOpt.set("lrs_histogram_limits", "off");
+
+  Stack<Clause*> clauses;
+  makeClauses(150, clauses);
+
+  AWPassiveClauseContainer hist(true, histOpt, "histogram");
+  AWPassiveClauseContainer sim(true, simOpt, "simulation");
+  Stack<Clause*>::Iterator cit(clauses);
+  while (cit.hasNext()) {
+    Clause* cl = cit.next();
+    hist.add(cl);
+    sim.add(cl);
+  }
+
+  static const long long estimates[] = {0, 1, 2, 3, 7, 20, 51, 100};
+  while (!sim.isEmpty()) {
+    for (long long est : estimates) {
+      hist.updateLimits(est);
+      sim.updateLimits(est);
+      checkSameLimits(hist, sim, clauses);
+    }
+    // move the cells and the balance
+    for (unsigned i=0; i<7 && !sim.isEmpty(); i++) {
+      Clause* cl = hist.popSelected();
+      Clause* expected = sim.popSelected();
+      ASS_EQ(cl, expected);
+    }
+  }
+  ASS(hist.isEmpty());
+}
@@ -0,0 +1,113 @@
+/*
+ * File tSaturationSteps.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file tSaturationSteps.cpp
+ * Unit test checking that a saturation run in slices by
+ * SaturationAlgorithm::runSteps ends as a single run
+ */
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID saturation_steps
+UT_CREATE;
+
+#include "Lib/Environment.hpp"
+#include "Lib/ScopedPtr.hpp"
+#include "Lib/VString.hpp"
+
+#include "Kernel/MainLoop.hpp"
+#include "Kernel/Problem.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "Saturation/SaturationAlgorithm.hpp"
+
+#include "Shell/Options.hpp"
+#include "Shell/Preprocess.hpp"
+#include "Shell/Statistics.hpp"
+
+using namespace Lib;
+using namespace Kernel;
+using namespace Saturation;
+using namespace Shell;
+
+static Problem* preprocessedProblem(const char* text)
+{
+  vistringstream inp(text);
+  Problem* prb = new Problem(Parse::TPTP::parse(inp));
+  Preprocess prepro(*env.options);
+  prepro.preprocess(*prb);
+  return prb;
+}
+
+/**
+ * Run the saturation on @b text at once and then one step at a time,
+ * and check both end with @b expected after the same number of activations
+ */
+static void checkSlicedRun(const char* text, Statistics::TerminationReason expected)
+{
+  unsigned activations;
+  {
+    ScopedPtr<Problem> prb(preprocessedProblem(text));
+    ScopedPtr<SaturationAlgorithm> salg(SaturationAlgorithm::createFromOptions(*prb, *env.options));
+    unsigned before = env.statistics->activeClauses;
+    MainLoopResult res = salg->run();
+    ASS_EQ(res.terminationReason, expected);
+    activations = env.statistics->activeClauses - before;
+  }
+
+  ScopedPtr<Problem> prb(preprocessedProblem(text));
+  ScopedPtr<SaturationAlgorithm> salg(SaturationAlgorithm::createFromOptions(*prb, *env.options));
+  unsigned before = env.statistics->activeClauses;
+  unsigned slices = 1;
+  MainLoopResult res = salg->runSteps(1);
+  while (res.terminationReason == Statistics::UNKNOWN) {
+    res = salg->runSteps(1);
+    slices++;
+  }
+  ASS_G(slices, 1);
+  ASS_EQ(res.terminationReason, expected);
+  ASS_EQ(env.statistics->activeClauses - before, activations);
+
+  // the finished run stays as it ended
+  MainLoopResult again = salg->runSteps(10);
+  ASS_EQ(again.terminationReason, expected);
+  ASS_EQ(again.refutation, res.refutation);
+  ASS_EQ(env.statistics->activeClauses - before, activations);
+}
+
+TEST_FUN(saturation_steps_refutation)
+{
+  checkSlicedRun(
+      "cnf(a,axiom, p(a))."
+      "cnf(b,axiom, ~p(X) | q(f(X)))."
+      "cnf(c,axiom, ~q(X) | r(X) | s(X))."
+      "cnf(d,axiom, ~s(X))."
+      "cnf(e,negated_conjecture, ~r(f(a))).",
+      Statistics::REFUTATION);
+}
+
+TEST_FUN(saturation_steps_satisfiable)
+{
+  checkSlicedRun(
+      "cnf(a,axiom, p(a))."
+      "cnf(b,axiom, ~p(X) | p(f(X)))."
+      "cnf(c,axiom, f(f(X))=X)."
+      "cnf(d,negated_conjecture, ~p(b)).",
+      Statistics::SATISFIABLE);
+}
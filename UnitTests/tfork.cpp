@@ -33,6 +33,7 @@ UT_CREATE;
 #include <unistd.h>
 #include <sys/wait.h>
 
+#include "Lib/Allocator.hpp"
 #include "Lib/Int.hpp"
 
 #include "Lib/Sys/Multiprocessing.hpp"
@@ -298,3 +299,51 @@ TEST_FUN(fork_and_kill3)
   ASS_EQ(c1res,256+SIGKILL);
   ASS_EQ(c2res,1);
 }
+
+TEST_FUN(fork_forgets_free_pieces)
+{
+  // what main does with fork_keeps_pieces_shared
+  Multiprocessing::instance()->registerForkHandlers(0,0,Allocator::forgetFreePieces);
+
+  static const unsigned PIECE_CNT = 100;
+  static const size_t PIECE_SIZE = 48;
+  void* pieces[PIECE_CNT];
+  for (unsigned i=0; i<PIECE_CNT; i++) {
+    pieces[i] = ALLOC_KNOWN(PIECE_SIZE, "tfork");
+  }
+  for (unsigned i=0; i<PIECE_CNT; i++) {
+    DEALLOC_KNOWN(pieces[i], PIECE_SIZE, "tfork");
+  }
+  size_t parentUsed = Allocator::getUsedMemory();
+
+  pid_t fres=Multiprocessing::instance()->fork();
+  ASS_NEQ(fres,-1);
+  if(!fres) {
+    //we're in the child
+    if (Allocator::getUsedMemory() > parentUsed-PIECE_CNT*PIECE_SIZE) {
+      exit(1);
+    }
+    // the new objects must not go to the pieces freed by the parent
+    for (unsigned i=0; i<PIECE_CNT; i++) {
+      void* mem = ALLOC_KNOWN(PIECE_SIZE, "tfork");
+      for (unsigned j=0; j<PIECE_CNT; j++) {
+        if (mem==pieces[j]) {
+          exit(2);
+        }
+      }
+    }
+    exit(0);
+  }
+
+  int status;
+  errno=0;
+  pid_t res=waitpid(fres, &status, 0);
+  if(res==-1) {
+    SYSTEM_FAIL("Error in waiting for forked process.",errno);
+  }
+  ASS_EQ(res,fres);
+  ASS(WIFEXITED(status));
+  ASS_EQ(WEXITSTATUS(status),0);
+  // the parent keeps reusing its pieces
+  ASS_EQ(Allocator::getUsedMemory(), parentUsed);
+}
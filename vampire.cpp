@@ -45,6 +45,7 @@
 #include "Lib/Vector.hpp"
 #include "Lib/System.hpp"
 #include "Lib/Metaiterators.hpp"
+#include "Lib/Sys/Multiprocessing.hpp"
 
 #include "Lib/RCPtr.hpp"
 
@@ -67,6 +68,7 @@
 
 #include "CASC/PortfolioMode.hpp"
 #include "CASC/CLTBMode.hpp"
+#include "CASC/ServerMode.hpp"
 #include "CASC/CLTBModeLearning.hpp"
 #include "Shell/CParser.hpp"
 #include "Shell/CommandLine.hpp"
@@ -870,6 +872,9 @@ int main(int argc, char* argv[])
     }
 
     Allocator::setMemoryLimit(env.options->memoryLimit() * 1048576ul);
+    if (env.options->forkKeepsPiecesShared()) {
+      Lib::Sys::Multiprocessing::instance()->registerForkHandlers(0,0,Allocator::forgetFreePieces);
+    }
     Lib::Random::setSeed(env.options->randomSeed());
 
     switch (env.options->mode())
@@ -977,6 +982,12 @@ int main(int argc, char* argv[])
       vampireReturnValue = VAMP_RESULT_STATUS_SUCCESS;
       break;
     }
+    case Options::Mode::SERVER:
+      env.options->setIgnoreMissing(Options::IgnoreMissing::WARN);
+      CASC::ServerMode::perform();
+      vampireReturnValue = VAMP_RESULT_STATUS_SUCCESS;
+      break;
+
     case Options::Mode::MODEL_CHECK:
       modelCheckMode();
       break;